@@ -1,18 +1,17 @@
 // guidance.c
 #include "guidance.h"
-#include <stdlib.h>
 #include <math.h>
+#include <stddef.h>
 
 #define EPSILON 1e-6f
+#define PI_F    3.14159265f
 
 bool guidance_state_init(GuidanceState *st, const GuidanceParams *p)
 {
-    if (!p || p->hist_size == 0 || p->buf_size == 0)
+    if (!p || p->hist_size == 0 || p->hist_size > MAX_HIST_SIZE || p->buf_size == 0)
         return false;
 
-    st->history.buf = malloc(p->hist_size * sizeof *st->history.buf);
-    if (!st->history.buf) 
-        return false;
+    st->history.buf  = st->hist_store;
     st->history.size = p->hist_size;
     st->history.idx  = 0;
 
@@ -34,13 +33,27 @@ bool guidance_state_init(GuidanceState *st, const GuidanceParams *p)
     return true;
 }
 
+// history lives in the state, kept so callers can still release a state
 void guidance_state_free(GuidanceState *st)
 {
-    free(st->history.buf);
     st->history.buf = NULL;
 }
 
-Direction guidance_step(const float *gbufx, const float *gbufy, uint32_t posx, uint32_t posy, GuidanceState *st, const GuidanceParams *p)
+/*
+ * Output when a sample is ignored: repeat the last direction, no correction.
+ */
+static GuidanceOutput guidance_hold(const GuidanceState *st)
+{
+    GuidanceOutput res = { st->last_dir, 0.0f, 0.0f };
+    return res;
+}
+
+/*
+ * Shared body of the guidance steps. Without a sign the turn side is found by
+ * trial, flipping when the ratio gets worse.
+ */
+static GuidanceOutput guidance_run(const float *gbufx, const float *gbufy, uint32_t posx, uint32_t posy,
+                                   bool has_sign, float xy_cross, GuidanceState *st, const GuidanceParams *p)
 {
     // --- 1) Read the most recent sample from your Goertzel buffers ---
     uint32_t ix = posx < p->buf_size ? posx : 0;
@@ -48,14 +61,19 @@ Direction guidance_step(const float *gbufx, const float *gbufy, uint32_t posx, u
     ix = ix ? ix - 1 : p->buf_size - 1;
     iy = iy ? iy - 1 : p->buf_size - 1;
 
+    // the buffers hold channel powers, |X|^2 and |Y|^2
     float Bpar  = fabsf(gbufx[ix]);
     float Bperp = fabsf(gbufy[iy]);
 
+    // angle between heading and field line, 0..pi/2, from the amplitudes
+    float ang = atan2f(sqrtf(Bperp), sqrtf(Bpar));
+
     // --- 2) Combined magnitude & weak-signal check ---
-    float mag = sqrtf(Bpar*Bpar + Bperp*Bperp);
+    // total power, the statistic the tracker's noise gate is solved for
+    float mag = Bpar + Bperp;
     if (mag < p->min_valid_mag) 
     {
-        return st->last_dir;
+        return guidance_hold(st);
     }
 
     // --- 3) First real measurement seeds your history buffer ---
@@ -67,7 +85,7 @@ Direction guidance_step(const float *gbufx, const float *gbufy, uint32_t posx, u
         }
         st->sum_history = mag * p->hist_size;
         st->seeded      = true;
-        return st->last_dir;
+        return guidance_hold(st);
     }
 
     // --- 4) Update rolling-history & compute previous average ---
@@ -93,6 +111,12 @@ Direction guidance_step(const float *gbufx, const float *gbufy, uint32_t posx, u
         }
     }
 
+    if (has_sign) 
+    {
+        // field side is known, no hunting
+        st->turn_dir = (xy_cross >= 0.0f ? +1 : -1);
+    }
+
     // --- 6) Steering (reverse_lock handled first) ---
     Direction out;
     if (st->reverse_lock) 
@@ -122,7 +146,6 @@ Direction guidance_step(const float *gbufx, const float *gbufy, uint32_t posx, u
     } else 
     {
         // --- 8) Normal forward steering via angle & ratio test ---
-        float ang = atan2f(Bperp, Bpar);
         if (fabsf(ang) <= p->fwd_thresh) 
         {
             out = STRAIGHT_AHEAD;
@@ -132,7 +155,7 @@ Direction guidance_step(const float *gbufx, const float *gbufy, uint32_t posx, u
             // ratio = Bpar / max(eps, Bperp)
             float denom = (Bperp > EPSILON ? Bperp : EPSILON);
             float ratio = Bpar / denom;
-            if (ratio < st->last_ratio) 
+            if (!has_sign && ratio < st->last_ratio) 
             {
                 st->turn_dir = -st->turn_dir;
             }
@@ -142,5 +165,46 @@ Direction guidance_step(const float *gbufx, const float *gbufy, uint32_t posx, u
     }
 
     st->last_dir = out;
-    return out;
+
+    // --- 9) Continuous output: signed turn onto the field line ---
+    GuidanceOutput res;
+    res.dir = out;
+    // while a U-turn is held only a known side is followed, so the reversed
+    // heading is kept along the field line
+    if (out == TURN_AROUND)
+        res.heading_corr = PI_F;
+    else if (st->reverse_lock && !has_sign)
+        res.heading_corr = 0.0f;
+    else
+        res.heading_corr = st->turn_dir * ang;
+
+    // margin over the weak-signal limit, halved when the side is a guess
+    res.confidence = (mag > EPSILON ? 1.0f - p->min_valid_mag / mag : 0.0f);
+    if (!has_sign)
+        res.confidence *= 0.5f;
+    return res;
+}
+
+Direction guidance_step(const float *gbufx, const float *gbufy, uint32_t posx, uint32_t posy, GuidanceState *st, const GuidanceParams *p)
+{
+    return guidance_run(gbufx, gbufy, posx, posy, false, 0.0f, st, p).dir;
+}
+
+/*
+ * As guidance_step(), with the X/Y cross term Re(X * conj(Y)) of the same
+ * sample. Its sign gives the side of the field angle: positive (channels in
+ * phase) turns left, negative turns right.
+ */
+Direction guidance_step_signed(const float *gbufx, const float *gbufy, uint32_t posx, uint32_t posy, float xy_cross, GuidanceState *st, const GuidanceParams *p)
+{
+    return guidance_run(gbufx, gbufy, posx, posy, true, xy_cross, st, p).dir;
+}
+
+/*
+ * Extended step. Returns the legacy direction plus a continuous heading
+ * correction and a confidence. xy_cross may be NULL when no phase is known.
+ */
+GuidanceOutput guidance_step_ext(const float *gbufx, const float *gbufy, uint32_t posx, uint32_t posy, const float *xy_cross, GuidanceState *st, const GuidanceParams *p)
+{
+    return guidance_run(gbufx, gbufy, posx, posy, xy_cross != NULL, xy_cross ? *xy_cross : 0.0f, st, p);
 }
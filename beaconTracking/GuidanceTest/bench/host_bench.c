@@ -0,0 +1,155 @@
+// bench/host_bench.c
+//
+// Host micro-benchmark for the firmware DSP, averaging and guidance kernels.
+// Runs every entry of bench_kernels[], prints one JSON object per kernel.
+//
+//   ./host_bench.exe [-r reps] [-k kernel] [-o out.json]
+//
+#define _POSIX_C_SOURCE 199309L
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench_kernels.h"
+
+#define DEFAULT_REPS   30
+#define WARMUP_NS      50000000.0   // 50 ms of warm-up per kernel
+#define MIN_SAMPLE_NS  2000000.0    // each timed sample lasts at least 2 ms
+
+static volatile float sink;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Two-sided 95% Student t critical values, index = degrees of freedom
+static double t95(int df)
+{
+    static const double t[] = {
+        0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+        2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093,
+        2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045,
+        2.042
+    };
+    if (df < 1)
+        return 0;
+    if (df <= 30)
+        return t[df];
+    return 1.96;
+}
+
+// Time `iters` calls of a kernel, prepare() is excluded from the time
+static double time_calls(const bench_kernel *k, long iters)
+{
+    double total = 0;
+
+    if (!k->prepare)
+    {
+        double t0 = now_ns();
+        for (long i = 0; i < iters; i++)
+            sink = k->run();
+        return now_ns() - t0;
+    }
+
+    for (long i = 0; i < iters; i++)
+    {
+        k->prepare();
+        double t0 = now_ns();
+        sink = k->run();
+        total += now_ns() - t0;
+    }
+    return total;
+}
+
+static void bench_one(FILE *out, const bench_kernel *k, int reps)
+{
+    // warm up caches and branch predictors, and find a batch size
+    long iters = 1;
+    double start = now_ns();
+    while (now_ns() - start < WARMUP_NS)
+    {
+        double t = time_calls(k, iters);
+        if (t < MIN_SAMPLE_NS)
+            iters *= 2;
+    }
+
+    double *ns_per_sample = malloc(reps * sizeof *ns_per_sample);
+    double mean = 0;
+    for (int r = 0; r < reps; r++)
+    {
+        double t = time_calls(k, iters);
+        ns_per_sample[r] = t / ((double)iters * k->samples);
+        mean += ns_per_sample[r];
+    }
+    mean /= reps;
+
+    double var = 0;
+    for (int r = 0; r < reps; r++)
+        var += (ns_per_sample[r] - mean) * (ns_per_sample[r] - mean);
+    var = reps > 1 ? var / (reps - 1) : 0;
+    double ci = t95(reps - 1) * sqrt(var / reps);
+
+    // samples/s interval is the reciprocal of the ns/sample interval
+    double sps     = 1e9 / mean;
+    double sps_lo  = 1e9 / (mean + ci);
+    double sps_hi  = mean > ci ? 1e9 / (mean - ci) : INFINITY;
+    double sps_ci  = (sps_hi - sps_lo) / 2;
+
+    fprintf(out,
+            "{\"kernel\":\"%s\",\"target\":\"host\",\"samples\":%u,\"reps\":%d,\"iters\":%ld,"
+            "\"ns_per_sample\":%.4f,\"ns_per_sample_ci95\":%.4f,"
+            "\"samples_per_s\":%.1f,\"samples_per_s_ci95\":%.1f}\n",
+            k->name, (unsigned)k->samples, reps, iters,
+            mean, ci, sps, isfinite(sps_ci) ? sps_ci : -1.0);
+    fflush(out);
+    free(ns_per_sample);
+}
+
+int main(int argc, char **argv)
+{
+    int reps = DEFAULT_REPS;
+    const char *only = NULL;
+    FILE *out = stdout;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc)
+            reps = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-k") && i + 1 < argc)
+            only = argv[++i];
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc)
+        {
+            out = fopen(argv[++i], "w");
+            if (!out)
+            {
+                perror("fopen");
+                return 1;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-r reps] [-k kernel] [-o out.json]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (reps < 2)
+        reps = 2;
+
+    bench_init();
+
+    fprintf(out, "{\"target\":\"host\",\"compiler\":\"%s\",\"reps\":%d}\n", __VERSION__, reps);
+    for (uint32_t i = 0; i < bench_kernel_count; i++)
+    {
+        if (only && strcmp(only, bench_kernels[i].name))
+            continue;
+        bench_one(out, &bench_kernels[i], reps);
+    }
+
+    if (out != stdout)
+        fclose(out);
+    return 0;
+}
@@ -0,0 +1,261 @@
+// sim/guidance_sim.c
+//
+// Host simulation of a searcher walking to a beacon with the guidance code.
+// The beacon is a dipole buried below the origin pointing along +x, the
+// searcher reads the horizontal field on two antennas (along and across its
+// heading) with noise, asks guidance for a turn and takes a step. The same
+// random starts are run with every steering mode and one JSON line per mode
+// is printed. The particle filter range estimate rides along with the
+// proportional mode and its error gets a line of its own.
+//
+//   ./guidance_sim.exe [-n trials] [-s seed] [-d depth_m]
+//
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "guidance.h"
+#include "pf.h"
+
+#define PI           3.14159265358979f
+#define STEP_M       0.5f     // distance walked per guidance update
+#define FOUND_M      1.0f     // horizontal distance counted as located
+#define DEPTH_M      1.0f     // default burial depth
+#define MAX_STEPS    2000
+#define START_MIN_M  10.0f
+#define START_MAX_M  35.0f
+#define REL_NOISE    0.05f    // multiplicative reading noise
+#define ABS_NOISE    1e-6f    // noise floor, field is 1 at 1 m
+#define BANG_TURN    (PI / 8) // fixed turn of the four way output
+#define PF_CHECKS    3        // range error checked after 5, 10 and 20 updates
+
+static const int pf_check_at[PF_CHECKS] = {5, 10, 20};
+
+typedef enum
+{
+    MODE_BANG_HUNT,     // guidance_step(), side found by trial
+    MODE_BANG_SIGNED,   // four way output with the X/Y sign
+    MODE_PROPORTIONAL,  // turn by heading_corr
+    MODE_COUNT
+} SimMode;
+
+static const char *mode_names[MODE_COUNT] = {
+    "bangbang_hunt", "bangbang_signed", "proportional"
+};
+
+static float depth = DEPTH_M;
+
+typedef struct
+{
+    int   located;
+    int   steps;
+    float path_ratio;   // distance walked / straight line distance
+    float pf_err[PF_CHECKS]; // relative range error, < 0 if located before
+} SimResult;
+
+static pf_filter pf;
+
+static uint32_t rng_state;
+
+static float rng_uniform(void)
+{
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (rng_state >> 8) * (1.0f / 16777216.0f);
+}
+
+static float rng_normal(void)
+{
+    float u1 = rng_uniform() + 1e-7f;
+    float u2 = rng_uniform();
+    return sqrtf(-2 * logf(u1)) * cosf(2 * PI * u2);
+}
+
+// horizontal part of the dipole field B = (3 (m.r) r - m) / |r|^3, m = x
+static void dipole(float x, float y, float *bx, float *by)
+{
+    float r2 = x * x + y * y + depth * depth;
+    float r = sqrtf(r2);
+    float r5 = r2 * r2 * r;
+    *bx = (3 * x * x - r2) / r5;
+    *by = (3 * x * y) / r5;
+}
+
+static float noisy(float v)
+{
+    return v * (1 + REL_NOISE * rng_normal()) + ABS_NOISE * rng_normal();
+}
+
+static SimResult run_trial(SimMode mode, float x, float y, float hdg)
+{
+    GuidanceParams p = {
+        .buf_size      = 1,
+        .hist_size     = 10,
+        .drop_steps    = 5,
+        .reverse_cd    = 20,
+        .fwd_thresh    = PI / 8,
+        .min_valid_mag = 0.0f
+    };
+    GuidanceState st;
+    guidance_state_init(&st, &p);
+
+    pf_params pp = {
+        .moment      = 1.0f,
+        .depth_m     = depth,
+        .range_min_m = 0.5f,
+        .range_max_m = 60.0f,
+        .step_m      = STEP_M,
+        .pos_sigma_m = 0.3f,
+        .turn_sigma  = 0.05f,
+        .mag_sigma   = 0.2f,
+        .ang_sigma   = 0.2f
+    };
+    pf_init(&pf, rng_state);
+
+    SimResult res = {0, MAX_STEPS, 0, {-1, -1, -1}};
+    float start = sqrtf(x * x + y * y);
+    float walked = 0;
+
+    for (int k = 0; k < MAX_STEPS; k++)
+    {
+        float bx, by;
+        dipole(x, y, &bx, &by);
+
+        // antenna readings along and across (to the left of) the heading
+        float hx = cosf(hdg), hy = sinf(hdg);
+        float bpar  = noisy(bx * hx + by * hy);
+        float bperp = noisy(-bx * hy + by * hx);
+        // guidance gets channel powers, as the tracker feeds it
+        float gx = bpar * bpar, gy = bperp * bperp;
+        float cross = bpar * bperp;
+
+        if (mode == MODE_PROPORTIONAL)
+        {
+            pf_update(&pf, &pp, bpar * bpar, bperp * bperp, cross);
+            pf_estimate est = pf_get_estimate(&pf);
+            float h = sqrtf(x * x + y * y);
+            for (int c = 0; c < PF_CHECKS; c++)
+                if ((int)pf.updates == pf_check_at[c])
+                    res.pf_err[c] = fabsf(est.range_m - h) / h;
+        }
+
+        float turn = 0;
+        if (mode == MODE_BANG_HUNT)
+        {
+            Direction d = guidance_step(&gx, &gy, 0, 0, &st, &p);
+            turn = d == TURN_LEFT ? BANG_TURN : d == TURN_RIGHT ? -BANG_TURN : d == TURN_AROUND ? PI : 0;
+        }
+        else
+        {
+            GuidanceOutput out = guidance_step_ext(&gx, &gy, 0, 0, &cross, &st, &p);
+            if (mode == MODE_BANG_SIGNED)
+                turn = out.dir == TURN_LEFT ? BANG_TURN : out.dir == TURN_RIGHT ? -BANG_TURN :
+                       out.dir == TURN_AROUND ? PI : 0;
+            else
+                turn = out.heading_corr;
+        }
+
+        if (mode == MODE_PROPORTIONAL)
+            pf_predict(&pf, &pp, turn);
+
+        hdg += turn;
+        x += STEP_M * cosf(hdg);
+        y += STEP_M * sinf(hdg);
+        walked += STEP_M;
+
+        if (sqrtf(x * x + y * y) < FOUND_M)
+        {
+            res.located = 1;
+            res.steps = k + 1;
+            break;
+        }
+    }
+
+    res.path_ratio = walked / start;
+    guidance_state_free(&st);
+    return res;
+}
+
+static int cmp_int(const void *a, const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+static int cmp_float(const void *a, const void *b)
+{
+    float fa = *(const float *)a, fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+int main(int argc, char **argv)
+{
+    int trials = 500;
+    uint32_t seed = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            trials = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-d") && i + 1 < argc)
+            depth = (float)atof(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [-n trials] [-s seed] [-d depth_m]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (trials < 1)
+        trials = 1;
+
+    int *steps = malloc(trials * sizeof *steps);
+    float *errs[PF_CHECKS];
+    int nerr[PF_CHECKS] = {0};
+    for (int c = 0; c < PF_CHECKS; c++)
+        errs[c] = malloc(trials * sizeof *errs[c]);
+
+    for (int m = 0; m < MODE_COUNT; m++)
+    {
+        int located = 0;
+        double steps_sum = 0, ratio_sum = 0;
+
+        for (int t = 0; t < trials; t++)
+        {
+            // same start for every mode, noise differs per run
+            rng_state = seed + 7919u * (uint32_t)t;
+            float r = START_MIN_M + (START_MAX_M - START_MIN_M) * rng_uniform();
+            float a = 2 * PI * rng_uniform();
+            float hdg = 2 * PI * rng_uniform();
+
+            SimResult res = run_trial((SimMode)m, r * cosf(a), r * sinf(a), hdg);
+            located += res.located;
+            steps[t] = res.steps;
+            steps_sum += res.steps;
+            ratio_sum += res.path_ratio;
+            for (int c = 0; c < PF_CHECKS; c++)
+                if (res.pf_err[c] >= 0)
+                    errs[c][nerr[c]++] = res.pf_err[c];
+        }
+
+        qsort(steps, trials, sizeof *steps, cmp_int);
+        printf("{\"mode\":\"%s\",\"depth_m\":%.1f,\"trials\":%d,\"located\":%d,\"steps_median\":%d,"
+               "\"steps_mean\":%.1f,\"path_ratio_mean\":%.2f}\n",
+               mode_names[m], depth, trials, located, steps[trials / 2],
+               steps_sum / trials, ratio_sum / trials);
+    }
+
+    // particle filter range error, median and 90th percentile
+    printf("{\"estimator\":\"pf\",\"depth_m\":%.1f,\"trials\":%d", depth, trials);
+    for (int c = 0; c < PF_CHECKS; c++)
+    {
+        qsort(errs[c], nerr[c], sizeof *errs[c], cmp_float);
+        float med = nerr[c] ? errs[c][nerr[c] / 2] : 0;
+        float p90 = nerr[c] ? errs[c][nerr[c] * 9 / 10] : 0;
+        printf(",\"rel_err_%d\":[%.2f,%.2f]", pf_check_at[c], med, p90);
+        free(errs[c]);
+    }
+    printf("}\n");
+
+    free(steps);
+    return 0;
+}
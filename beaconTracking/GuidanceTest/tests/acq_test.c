@@ -0,0 +1,91 @@
+// tests/acq_test.c
+#include <stdio.h>
+#include "acq.h"
+
+// Convenience macro for succinct PASS/FAIL reporting
+#define RUN(desc, cond) do {                                           \
+    if (!(cond)) {                                                     \
+        fprintf(stderr, "[FAIL] %s\n", desc);                         \
+        return 1;                                                      \
+    } else {                                                           \
+        printf("[PASS] %s\n", desc);                                  \
+    }                                                                  \
+} while (0)
+
+#define BURST_MS  10
+#define ON_MS     70
+#define PERIOD_MS 470
+
+static int in_pulse(unsigned t)
+{
+    return t >= 200 && (t - 200) % PERIOD_MS < ON_MS;
+}
+
+int main(void) {
+    const pulse_params params = {
+        .on_ratio      = 4.0f,
+        .off_ratio     = 2.0f,
+        .floor_alpha   = 0.05f,
+        .min_period_ms = 100,
+        .max_period_ms = 2000,
+        .period_tol    = 0.15f,
+        .lock_count    = 2,
+        .guard_ms      = 2 * BURST_MS,
+        .miss_count    = 3
+    };
+    pulse_detector pd;
+    acq_sched s;
+    pulse_init(&pd);
+    acq_init(&s);
+
+    //
+    // 1) Scan every slot until the detector locks
+    //
+    unsigned t = 0;
+    int scan_skips = 0;
+    while (s.state == ACQ_SCAN && t < 10000) {
+        if (acq_burst_due(&s, t)) {
+            pulse_update(&pd, &params, t, in_pulse(t) ? 3000.0f : 100.0f);
+            acq_sync(&s, &pd, &params, 1);
+        }
+        else {
+            scan_skips++;
+        }
+        t += BURST_MS;
+    }
+    RUN("every slot used while scanning", scan_skips == 0);
+    RUN("scheduler locks", s.state == ACQ_LOCKED);
+
+    //
+    // 2) Locked: all pulse slots used, most others idle
+    //
+    unsigned end = t + 50 * PERIOD_MS;
+    s.bursts = 0;
+    s.skipped = 0;
+    int missed = 0;
+    for (; t < end; t += BURST_MS) {
+        if (acq_burst_due(&s, t)) {
+            pulse_update(&pd, &params, t, in_pulse(t) ? 3000.0f : 100.0f);
+            acq_sync(&s, &pd, &params, 1);
+        }
+        else if (in_pulse(t)) {
+            missed++;
+        }
+    }
+    RUN("no pulse slot skipped", missed == 0);
+    RUN("stays locked", s.state == ACQ_LOCKED);
+    RUN("burst load cut by 3x or more", s.skipped >= 2 * s.bursts);
+
+    //
+    // 3) Beacon stops, back to scanning
+    //
+    end = t + 5 * PERIOD_MS;
+    for (; t < end; t += BURST_MS) {
+        if (acq_burst_due(&s, t))
+            pulse_update(&pd, &params, t, 100.0f);
+    }
+    RUN("falls back to scanning", s.state == ACQ_SCAN);
+
+    printf("ALL TESTS PASSED\n");
+    return 0;
+}
@@ -0,0 +1,124 @@
+// tests/cfar_test.c
+#include <stdio.h>
+#include <math.h>
+#include "cfar.h"
+
+// Convenience macro for succinct PASS/FAIL reporting
+#define RUN(desc, cond) do {                                           \
+    if (!(cond)) {                                                     \
+        fprintf(stderr, "[FAIL] %s\n", desc);                         \
+        return 1;                                                      \
+    } else {                                                           \
+        printf("[PASS] %s\n", desc);                                  \
+    }                                                                  \
+} while (0)
+
+static unsigned seed = 11;
+
+// exponential with unit mean, the power of a noise only bin
+static float noise(void) {
+    seed = seed * 1103515245u + 12345u;
+    return -logf(((seed >> 8) + 1.0f) / 16777217.0f);
+}
+
+int main(void) {
+    cfar_detector cf;
+
+    //
+    // 1) Threshold factor meets the false alarm formula
+    //
+    float a = cfar_alpha(32, 24, 1, 1, 1e-3f);
+    double pfa = 1;
+    for (int i = 0; i < 24; i++) pfa *= (32.0 - i) / (32.0 - i + a);
+    RUN("alpha solves for pfa", fabs(pfa - 1e-3) < 1e-5);
+
+    //
+    // 2) Not ready until the window fills, everything passes until then
+    //
+    const cfar_params p = {.window = 32, .rank = 24, .pfa = 1e-2f, .looks = 1};
+    cfar_init(&cf, &p);
+    for (int i = 0; i < 31; i++) cfar_push(&cf, noise());
+    RUN("not ready on a part window", !cfar_ready(&cf) && cfar_detect(&cf, 0.0f));
+    cfar_push(&cf, noise());
+    RUN("ready on a full window", cfar_ready(&cf));
+
+    //
+    // 3) False alarm rate on exponential noise
+    //
+    int alarms = 0, tests = 200000;
+    for (int i = 0; i < tests; i++) {
+        alarms += cfar_detect(&cf, noise());
+        cfar_push(&cf, noise());
+    }
+    float rate = (float)alarms / tests;
+    RUN("false alarm rate near pfa", rate > 0.5f * p.pfa && rate < 2.0f * p.pfa);
+
+    //
+    // 4) A few interfering pulses in the window leave the floor alone
+    //
+    cfar_init(&cf, &p);
+    for (int i = 0; i < 32; i++) cfar_push(&cf, 1.0f + 0.01f * i);
+    float clean = cfar_threshold(&cf);
+    for (int i = 0; i < 4; i++) cfar_push(&cf, 1e6f);
+    RUN("outliers ignored", cfar_threshold(&cf) < 1.1f * clean);
+
+    //
+    // 5) Floor follows a rising noise level, oldest readings drop out
+    //
+    for (int i = 0; i < 32; i++) cfar_push(&cf, 10.0f);
+    RUN("floor follows the noise", fabsf(cfar_threshold(&cf) - 10.0f * cf.alpha) < 1e-3f);
+
+    //
+    // 6) The tracker's statistic, X + Y power, a sum of two exponentials:
+    //    the two look factor meets the design rate, the one look factor
+    //    does not
+    //
+    RUN("integrated pfa matches the formula at one look",
+        fabsf(cfar_pfa(32, 24, 1, 1, a) / 1e-3f - 1) < 1e-3f);
+    const cfar_params p2 = {.window = 32, .rank = 24, .pfa = 1e-3f, .looks = 2};
+    cfar_init(&cf, &p2);
+    printf("alpha %.3f for one look, %.3f for two\n", a, cf.alpha);
+    RUN("two look pfa solved", fabsf(cfar_pfa(32, 24, 2, 1, cf.alpha) / 1e-3f - 1) < 1e-2f);
+    for (int i = 0; i < 32; i++) cfar_push(&cf, noise() + noise());
+    int alarms2 = 0, alarms1 = 0;
+    tests = 1000000;
+    for (int i = 0; i < tests; i++) {
+        float x = noise() + noise();
+        alarms2 += cfar_detect(&cf, x);
+        alarms1 += x > a * cf.sorted[cf.rank - 1];
+        cfar_push(&cf, noise() + noise());
+    }
+    float rate2 = (float)alarms2 / tests, rate1 = (float)alarms1 / tests;
+    printf("X + Y false alarms: %.2e with the two look factor, %.2e with one\n", rate2, rate1);
+    RUN("two look rate near pfa", rate2 > 0.7f * p2.pfa && rate2 < 1.4f * p2.pfa);
+    RUN("one look factor misses it", rate1 < 0.1f * p2.pfa);
+
+    //
+    // 7) Smoothed X + Y power, the mean of 5 readings, tested against the
+    //    floor of single readings: the averaged factor is lower and still
+    //    meets the design rate, the single reading factor gates far above it
+    //
+    const cfar_params p5 = {.window = 32, .rank = 24, .pfa = 1e-3f, .looks = 2, .avg = 5};
+    cfar_detector cf5;
+    cfar_init(&cf5, &p5);
+    printf("alpha %.3f for the mean of 5\n", cf5.alpha);
+    RUN("averaged factor lower", cf5.alpha < 0.7f * cf.alpha);
+    RUN("averaged pfa solved", fabsf(cfar_pfa(32, 24, 2, 5, cf5.alpha) / 1e-3f - 1) < 1e-2f);
+    for (int i = 0; i < 32; i++) cfar_push(&cf5, noise() + noise());
+    int alarms5 = 0, alarms5_one = 0;
+    for (int i = 0; i < tests; i++) {
+        float m = 0;
+        for (int j = 0; j < 5; j++) m += noise() + noise();
+        m /= 5;
+        alarms5 += cfar_detect(&cf5, m);
+        alarms5_one += m > cf.alpha * cfar_floor(&cf5);
+        cfar_push(&cf5, noise() + noise());
+    }
+    float rate5 = (float)alarms5 / tests, rate5_one = (float)alarms5_one / tests;
+    printf("mean of 5 false alarms: %.2e with its factor, %.2e with the single reading one\n", rate5, rate5_one);
+    RUN("averaged rate near pfa", rate5 > 0.7f * p5.pfa && rate5 < 1.4f * p5.pfa);
+    RUN("single reading factor misses it", rate5_one < 0.1f * p5.pfa);
+
+    printf("ALL TESTS PASSED\n");
+    return 0;
+}
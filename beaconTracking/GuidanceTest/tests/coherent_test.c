@@ -0,0 +1,127 @@
+// tests/coherent_test.c
+#include <stdio.h>
+#include <math.h>
+#include "coherent.h"
+
+// Convenience macro for succinct PASS/FAIL reporting
+#define RUN(desc, cond) do {                                           \
+    if (!(cond)) {                                                     \
+        fprintf(stderr, "[FAIL] %s\n", desc);                         \
+        return 1;                                                      \
+    } else {                                                           \
+        printf("[PASS] %s\n", desc);                                  \
+    }                                                                  \
+} while (0)
+
+#define PI_TEST 3.14159265
+#define FS 3600000.0
+#define F0 457000.0
+#define CPU 216000000.0
+#define N 3600
+#define BURSTS 8
+
+static int16_t window[N];
+static int16_t buf[N];
+static goertzel_plan plan;
+static unsigned seed = 7;
+
+static double noise(void) {
+    // roughly unit variance, sum of uniforms
+    double s = 0;
+    for (int k = 0; k < 12; k++) {
+        seed = seed * 1103515245u + 12345u;
+        s += (seed >> 8) / 16777216.0;
+    }
+    return s - 6;
+}
+
+// windowed bin of a burst starting at DWT count t, the tone's phase runs on
+// from the start of the pulse
+static dsp_complex burst(double f, double amp, double sigma, uint32_t t) {
+    for (int i = 0; i < N; i++) {
+        double ts = t / CPU + i / FS;
+        double v = amp * cos(2 * PI_TEST * f * ts + 0.7) + sigma * noise();
+        buf[i] = (int16_t) (2048 + lrint(v));
+    }
+    dsp_window_q15(buf, window, N, 2048);
+    return goertzel_bin_f32(&plan, buf);
+}
+
+static coh_result pulse(double f, double ax, double ay, double sigma, uint32_t t0) {
+    coh_integrator ci;
+    coh_start(&ci, F0, CPU, t0);
+    for (int b = 0; b < BURSTS; b++) {
+        // 10 ms slots with a little interrupt latency
+        uint32_t t = t0 + b * 2160000u + (b * 37) % 101;
+        dsp_complex x = burst(f, ax, sigma, t);
+        dsp_complex y = burst(f, ay, sigma, t);
+        coh_push(&ci, t, x, y);
+    }
+    return coh_finish(&ci);
+}
+
+int main(void) {
+    for (int i = 0; i < N; i++) {
+        double t = 2 * PI_TEST * i / (N - 1);
+        double w = 0.21557895 - 0.41663158 * cos(t) + 0.277263158 * cos(2 * t)
+                   - 0.083578947 * cos(3 * t) + 0.006947368 * cos(4 * t);
+        window[i] = (int16_t) (w * 32767);
+    }
+    goertzel_plan_init(&plan, F0, FS, N);
+
+    // one burst's power, the reference
+    double ref = dsp_power(burst(F0, 500, 0, 0));
+
+    //
+    // 1) A clean carrier adds up fully, starting anywhere on the counter
+    //
+    coh_result r = pulse(F0, 500, 250, 0, 4000000000u);
+    printf("gain %.2f dB, coherence %.4f, offset %.2f Hz\n", r.gain_db, r.coherence, r.offset_hz);
+    RUN("all bursts integrated", r.n == BURSTS);
+    RUN("coherence 1", r.coherence > 0.999f);
+    RUN("gain 10 log10(n)", fabs(r.gain_db - 10 * log10(BURSTS)) < 0.05);
+    RUN("power in one burst's units", fabs(r.px / ref - 1) < 0.01 && fabs(r.py / ref - 0.25) < 0.01);
+    RUN("cross term in phase", r.pxy > 0 && fabs(r.pxy / ref - 0.5) < 0.01);
+
+    //
+    // 2) A residual offset is found and taken out
+    //
+    r = pulse(F0 + 12, 500, -250, 0, 123456);
+    printf("gain %.2f dB, coherence %.4f, offset %.2f Hz\n", r.gain_db, r.coherence, r.offset_hz);
+    RUN("12 Hz residual found", fabs(r.offset_hz - 12) < 0.2);
+    RUN("still coherent", r.coherence > 0.999f);
+    RUN("cross term in antiphase", r.pxy < 0);
+
+    //
+    // 3) A weak carrier in noise is still recovered and gains nearly n
+    //
+    double sig = 40, sigma = 160;
+    double ref_s = dsp_power(burst(F0, sig, 0, 0));
+    double px = 0, gain = 0;
+    for (int k = 0; k < 20; k++) {
+        r = pulse(F0 + 3, sig, sig, sigma, k * 99991u);
+        px += r.px;
+        gain += r.gain_db;
+    }
+    printf("weak carrier: power %.0f of %.0f, gain %.2f dB\n", px / 20, ref_s, gain / 20);
+    RUN("weak carrier power", fabs(px / 20 / ref_s - 1) < 0.15);
+    RUN("weak carrier gain", gain / 20 > 8);
+
+    //
+    // 4) Noise alone mostly cancels in the sum, and gets no gain
+    //
+    double coh = 0, inc = 0;
+    gain = 0;
+    for (int k = 0; k < 20; k++) {
+        r = pulse(F0, 0, 0, sigma, k * 77777u);
+        coh += r.px;
+        gain += r.gain_db;
+        for (int b = 0; b < BURSTS; b++) inc += dsp_power(burst(F0, 0, sigma, b * 2160000u)) / BURSTS;
+    }
+    printf("noise only: coherent %.0f, power average %.0f, gain %.2f dB\n", coh / 20, inc / 20, gain / 20);
+    RUN("noise cut by the coherent sum", coh < 0.35 * inc);
+    RUN("noise only under 3 dB", gain / 20 < 3);
+
+    printf("ALL TESTS PASSED\n");
+    return 0;
+}
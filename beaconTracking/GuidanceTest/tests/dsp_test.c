@@ -0,0 +1,275 @@
+// tests/dsp_test.c
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "dsp.h"
+
+// Convenience macro for succinct PASS/FAIL reporting
+#define RUN(desc, cond) do {                                           \
+    if (!(cond)) {                                                     \
+        fprintf(stderr, "[FAIL] %s\n", desc);                         \
+        return 1;                                                      \
+    } else {                                                           \
+        printf("[PASS] %s\n", desc);                                  \
+    }                                                                  \
+} while (0)
+
+#define N 512
+
+static int16_t raw[N], a[N], b[N], window[N], hann[N];
+
+/*
+ * Bin k of the raw block windowed in double precision, the reference. Same
+ * recurrence and scaling as the firmware Goertzel.
+ */
+static dsp_complex ref_bin(const int16_t *x, const int16_t *w, int k, int16_t dc) {
+    double om = 2 * 3.14159265358979 * k / N;
+    double q1 = 0, q2 = 0;
+    for (int i = 0; i < N; i++) {
+        double q0 = (x[i] - dc) * (double) w[i] / 4096 + 2 * cos(om) * q1 - q2;
+        q2 = q1;
+        q1 = q0;
+    }
+    dsp_complex z = {(float) ((q1 * cos(om) - q2) / (N / 2.0)), (float) (q1 * sin(om) / (N / 2.0))};
+    return z;
+}
+
+static double ref_power(const int16_t *x, const int16_t *w, int k, int16_t dc) {
+    return dsp_power(ref_bin(x, w, k, dc));
+}
+
+static double err_power(dsp_complex z, dsp_complex r) {
+    dsp_complex e = {z.re - r.re, z.im - r.im};
+    return dsp_power(e);
+}
+
+/*
+ * A tone of amp counts at bin k in noise of sigma counts, quantised like the
+ * ADC.
+ */
+static unsigned nseed = 11;
+static void weak_block(int16_t *x, double amp, double sigma, int k) {
+    for (int i = 0; i < N; i++) {
+        double n = 0;
+        for (int j = 0; j < 12; j++) {
+            nseed = nseed * 1103515245u + 12345u;
+            n += (nseed >> 8) / 16777216.0;
+        }
+        double v = 2048 + amp * cos(2 * 3.14159265358979 * k * i / N + 0.3) + sigma * (n - 6);
+        x[i] = (int16_t) lrint(v);
+    }
+}
+
+int main(void) {
+    unsigned seed = 5;
+    for (int i = 0; i < N; i++) {
+        seed = seed * 1103515245u + 12345u;
+        raw[i] = 1000 + (int16_t)((seed >> 16) % 2000);
+        window[i] = (int16_t)(32767 * i / N);
+    }
+
+    //
+    // 1) Windowing with stats matches plain windowing
+    //
+    dsp_clip_stats st;
+    memcpy(a, raw, sizeof(a));
+    memcpy(b, raw, sizeof(b));
+    dsp_window_q15(a, window, N, 2048);
+    dsp_window_q15_stats(b, window, N, 2048, &st);
+    RUN("same windowed output", memcmp(a, b, sizeof(a)) == 0);
+
+    //
+    // 2) Extremes and no clipping inside the rails
+    //
+    int16_t mn = raw[0], mx = raw[0];
+    int32_t sum = raw[0];
+    for (int i = 1; i < N; i++) {
+        if (raw[i] < mn) mn = raw[i];
+        if (raw[i] > mx) mx = raw[i];
+        sum += raw[i];
+    }
+    RUN("min", st.min == mn);
+    RUN("max", st.max == mx);
+    RUN("no clipping", st.clipped == 0 && !dsp_saturated(&st));
+    RUN("sum", st.sum == sum);
+
+    //
+    // 3) Samples at and beyond the rails are counted, on both lanes
+    //
+    memcpy(b, raw, sizeof(b));
+    b[10] = 4095;  b[11] = DSP_CLIP_HI;  b[12] = DSP_CLIP_HI - 1;
+    b[101] = 0;    b[200] = DSP_CLIP_LO; b[301] = DSP_CLIP_LO + 1;
+    dsp_window_q15_stats(b, window, N, 2048, &st);
+    RUN("clipped count", st.clipped == 4 && dsp_saturated(&st));
+    RUN("rails in min and max", st.min == 0 && st.max == 4095);
+
+    //
+    // 4) The dc estimate follows a bias off 2048 from the windowing pass, a
+    //    ramp of half a count per burst lags by about 1 / alpha of it
+    //
+    dsp_dc_tracker dc;
+    dsp_dc_init(&dc, 2048, 1.0f / 16);
+    for (int burst = 0; burst < 60; burst++) {
+        // bias drifting by a count every other burst, whole tone cycles
+        int16_t bias = 2180 + burst / 2;
+        for (int i = 0; i < N; i++) {
+            b[i] = (int16_t) (bias + lrintf(500 * cosf(2 * 3.14159265f * 8 * i / N)));
+        }
+        dsp_window_q15_stats(b, window, N, dsp_dc_get(&dc), &st);
+        dsp_dc_update(&dc, &st, N);
+    }
+    printf("dc estimate %.1f for a bias of 2209\n", dc.dc);
+    RUN("dc follows the bias", fabsf(dc.dc - 2209) < 10);
+
+    // a burst clipped at a rail does not pull it
+    float before = dc.dc;
+    for (int i = 0; i < N; i++) {
+        b[i] = 4095;
+    }
+    dsp_window_q15_stats(b, window, N, dsp_dc_get(&dc), &st);
+    dsp_dc_update(&dc, &st, N);
+    RUN("clipped burst ignored", dc.dc == before);
+
+    //
+    // 5) Fixed point fused path: same bin as the float path at full scale,
+    //    and no weak signal loss against a double reference
+    //
+    for (int i = 0; i < N; i++) {
+        hann[i] = (int16_t) lrint(32767 * 0.5 * (1 - cos(2 * 3.14159265358979 * i / N)));
+    }
+    goertzel_plan plan;
+    goertzel_plan_init_bin(&plan, 64, N);
+
+    for (int i = 0; i < N; i++) {
+        b[i] = (int16_t) lrint(2048 + 2040 * cos(2 * 3.14159265358979 * 64 * i / N));
+    }
+    double pr = ref_power(b, hann, 64, 2048);
+    float pq = goertzel_power_fused_q31(&plan, b, hann, 2048, DSP_Q31_HEADROOM);
+    float pf = goertzel_power_fused(&plan, b, hann, 2048);
+    printf("full scale: q31 %.6g, float %.6g, reference %.6g\n", pq, pf, pr);
+    RUN("q31 full scale matches", fabs(pq / pr - 1) < 1e-4);
+
+    // with no headroom the state clips instead of wrapping, the bin reads
+    // low like a clipped burst
+    float pclip = goertzel_power_fused_q31(&plan, b, hann, 2048, 0);
+    printf("no headroom: %.6g\n", pclip);
+    RUN("q31 saturates without headroom", pclip > 0.01 * pr && pclip < pr);
+
+    // weak tone, about an LSB after windowing: SNR as the excess over noise
+    // only blocks against their power, and the error each path adds to the
+    // double precision bin
+    double sig[3] = {0, 0, 0}, noi[3] = {0, 0, 0}, err[3] = {0, 0, 0};
+    for (int t = 0; t < 200; t++) {
+        for (int with = 0; with < 2; with++) {
+            weak_block(b, with ? 0.5 : 0, 0.4, 64);
+            memcpy(a, b, sizeof(a));
+            dsp_window_q15(a, hann, N, 2048);
+            dsp_complex z[3] = {
+                ref_bin(b, hann, 64, 2048),
+                goertzel_bin_fused_q31(&plan, b, hann, 2048, DSP_Q31_HEADROOM),
+                goertzel_bin_f32(&plan, a),
+            };
+            for (int m = 0; m < 3; m++) {
+                if (with) sig[m] += dsp_power(z[m]); else noi[m] += dsp_power(z[m]);
+                err[m] += err_power(z[m], z[0]);
+            }
+        }
+    }
+    double snr[3];
+    for (int m = 0; m < 3; m++) {
+        snr[m] = 10 * log10((sig[m] - noi[m]) / noi[m]);
+    }
+    printf("weak tone SNR: reference %.2f dB, q31 %.2f dB, float after >> 12 %.2f dB\n", snr[0], snr[1], snr[2]);
+    printf("error added to the bin: q31 %.3g, float after >> 12 %.3g (noise %.3g)\n",
+           err[1] / 400, err[2] / 400, noi[0] / 200);
+    RUN("q31 weak signal SNR as the reference", fabs(snr[1] - snr[0]) < 0.05);
+    RUN("q31 adds less error than the float path", err[1] < 0.01 * err[2]);
+
+    //
+    // 6) Both channels in one loop give the same bins as two calls
+    //
+    for (int i = 0; i < N; i++) {
+        a[i] = (int16_t) lrint(1500 * cos(2 * 3.14159265358979 * 64.3 * i / N));
+        b[i] = (int16_t) lrint(-400 * sin(2 * 3.14159265358979 * 64.3 * i / N) + 30 * cos(0.1 * i));
+    }
+    dsp_complex zx, zy;
+    goertzel_bin_dual(&plan, a, b, &zx, &zy);
+    dsp_complex rx = goertzel_bin_f32(&plan, a);
+    dsp_complex ry = goertzel_bin_f32(&plan, b);
+    RUN("dual X bin", zx.re == rx.re && zx.im == rx.im);
+    RUN("dual Y bin", zy.re == ry.re && zy.im == ry.im);
+    float px, py;
+    goertzel_power_dual(&plan, a, b, &px, &py);
+    RUN("dual powers", px == dsp_power(rx) && py == dsp_power(ry));
+
+    //
+    // 7) Bin 0 has coeff 2, which the fixed point coefficient holds exactly
+    //
+    goertzel_plan dc_plan;
+    goertzel_plan_init_bin(&dc_plan, 0, N);
+    for (int i = 0; i < N; i++) {
+        a[i] = 5;
+    }
+    float pdc = goertzel_power_f32(&dc_plan, a);
+    float pdc_q = goertzel_power_q31(&dc_plan, a);
+    RUN("bin 0 coefficient", dc_plan.coeff_q29 == (1 << 30));
+    RUN("bin 0 q31 power matches", fabsf(pdc_q / pdc - 1) < 1e-3f);
+
+    //
+    // 8) Fused multibin pass: each bin as the single bin fixed point kernel,
+    //    the statistics as the windowing pass, the block left alone
+    //
+    goertzel_plan plans3[3];
+    for (int k = 0; k < 3; k++) {
+        goertzel_plan_init_bin(&plans3[k], 63 + k, N);
+    }
+    weak_block(b, 1500, 20, 64);
+    b[7] = 4095;
+    memcpy(a, b, sizeof(a));
+    dsp_complex z3[3];
+    dsp_clip_stats st3;
+    goertzel_bin_multibin_fused_q31(plans3, 3, b, hann, 2048, DSP_Q31_HEADROOM, &st3, z3);
+    int same = 1;
+    for (int k = 0; k < 3; k++) {
+        dsp_complex r = goertzel_bin_fused_q31(&plans3[k], b, hann, 2048, DSP_Q31_HEADROOM);
+        same &= z3[k].re == r.re && z3[k].im == r.im;
+    }
+    RUN("multibin q31 bins match", same);
+    RUN("block untouched", memcmp(a, b, sizeof(a)) == 0);
+    dsp_window_q15_stats(a, hann, N, 2048, &st);
+    RUN("multibin q31 statistics", st3.min == st.min && st3.max == st.max && st3.clipped == st.clipped
+                                   && st3.sum == st.sum);
+
+    //
+    // 9) Statistics are taken two samples at a time: an odd block with rails
+    //    in both lanes and in the last sample reads as a plain scan of it,
+    //    through the raw and the fused multibin passes
+    //
+    const uint32_t n_odd = N - 1;
+    goertzel_plan odd[2];
+    goertzel_plan_init_bin(&odd[0], 31, n_odd);
+    goertzel_plan_init_bin(&odd[1], 32, n_odd);
+    memcpy(b, raw, sizeof(b));
+    b[20] = 4095;  b[21] = 0;  b[40] = DSP_CLIP_LO;  b[n_odd - 1] = DSP_CLIP_HI;
+    int16_t rmin = INT16_MAX, rmax = INT16_MIN;
+    uint32_t rcnt = 0;
+    int32_t rsum = 0;
+    for (uint32_t i = 0; i < n_odd; i++) {
+        rmin = b[i] < rmin ? b[i] : rmin;
+        rmax = b[i] > rmax ? b[i] : rmax;
+        rcnt += (b[i] <= DSP_CLIP_LO) + (b[i] >= DSP_CLIP_HI);
+        rsum += b[i];
+    }
+    dsp_complex zo[2];
+    dsp_clip_stats st_raw, st_fused;
+    goertzel_bin_multibin_raw(odd, 2, b, 2048, 1.0f, &st_raw, zo);
+    goertzel_bin_multibin_fused_q31(odd, 2, b, hann, 2048, DSP_Q31_HEADROOM, &st_fused, zo);
+    RUN("raw pass statistics", st_raw.min == rmin && st_raw.max == rmax && st_raw.clipped == rcnt
+                               && st_raw.sum == rsum);
+    RUN("fused pass statistics", st_fused.min == rmin && st_fused.max == rmax && st_fused.clipped == rcnt
+                                 && st_fused.sum == rsum);
+    RUN("last sample counted", rcnt == 4);
+
+    printf("ALL TESTS PASSED\n");
+    return 0;
+}
@@ -0,0 +1,201 @@
+// tests/freq_test.c
+#include <stdio.h>
+#include <math.h>
+#include "freq.h"
+
+// Convenience macro for succinct PASS/FAIL reporting
+#define RUN(desc, cond) do {                                           \
+    if (!(cond)) {                                                     \
+        fprintf(stderr, "[FAIL] %s\n", desc);                         \
+        return 1;                                                      \
+    } else {                                                           \
+        printf("[PASS] %s\n", desc);                                  \
+    }                                                                  \
+} while (0)
+
+#define PI_TEST 3.14159265f
+#define FS 3600000.0f
+#define F0 457000.0f
+#define N 3600
+
+static int16_t window[N];
+static float rect_gain;
+static int16_t buf[N];
+static unsigned seed = 1;
+
+static const freq_params params =
+{
+    .span          = 2.0f,
+    .slope         = 1.686f,
+    .alpha         = 0.3f,
+    .max_offset_hz = 3000.0f,
+    .retune_pulses = 2,
+    .retune_hz     = 5.0f
+};
+
+// raw burst of a tone at f with a random start phase
+static void burst_raw(float f) {
+    seed = seed * 1103515245u + 12345u;
+    float ph = (seed >> 8) * (2 * PI_TEST / 16777216.0f);
+    for (int i = 0; i < N; i++) {
+        buf[i] = (int16_t) (2048 + lrintf(1000 * cosf(2 * PI_TEST * f * i / FS + ph)));
+    }
+}
+
+// windowed burst
+static void burst(float f) {
+    burst_raw(f);
+    dsp_window_q15(buf, window, N, 2048);
+}
+
+// the bins of a burst the way the application takes them, with or without
+// the window as the tracker asks
+static void burst_bins(const freq_tracker *ft, float f, dsp_complex *z) {
+    if (freq_rect(ft)) {
+        dsp_clip_stats st;
+        burst_raw(f);
+        goertzel_bin_multibin_raw(ft->plans, FREQ_BINS, buf, 2048, rect_gain, &st, z);
+    }
+    else {
+        burst(f);
+        goertzel_bin_multibin(ft->plans, FREQ_BINS, buf, z);
+    }
+}
+
+// run pulses of four bursts through the tracker
+static void pulses(freq_tracker *ft, const freq_params *p, float f, int count) {
+    for (int k = 0; k < count; k++) {
+        for (int b = 0; b < 4; b++) {
+            dsp_complex z[FREQ_BINS];
+            float pw[FREQ_BINS];
+            burst_bins(ft, f, z);
+            for (int j = 0; j < FREQ_BINS; j++) pw[j] = dsp_power(z[j]);
+            freq_push(ft, pw);
+        }
+        freq_pulse_end(ft, p);
+    }
+}
+
+static float centre_power(const freq_tracker *ft, float f) {
+    burst(f);
+    return goertzel_power_f32(&ft->plans[FREQ_CENTRE], buf);
+}
+
+int main(void) {
+    for (int i = 0; i < N; i++) {
+        float t = 2 * PI_TEST * i / (N - 1);
+        float w = 0.21557895f - 0.41663158f * cosf(t) + 0.277263158f * cosf(2 * t)
+                  - 0.083578947f * cosf(3 * t) + 0.006947368f * cosf(4 * t);
+        window[i] = (int16_t) (w * 32767);
+        rect_gain += window[i];
+    }
+    rect_gain /= 4096.0f * N;
+
+    //
+    // 1) Interpolation
+    //
+    RUN("centred peak reads 0", freq_interp(2, 4, 2) == 0.0f);
+    RUN("heavier above reads positive", freq_interp(1, 4, 2) > 0);
+    RUN("heavier below reads negative", freq_interp(2, 4, 1) < 0);
+    RUN("no peak reads 0", freq_interp(3, 1, 3) == 0.0f && freq_interp(0, 2, 1) == 0.0f);
+
+    //
+    // 2) Settles on an off nominal tone and recovers the power the window lost
+    //
+    freq_tracker ft;
+    freq_init(&ft, &params, F0, FS, N);
+    float f = F0 + 2500;
+    goertzel_plan exact;
+    goertzel_plan_init_frac(&exact, f * N / FS, N);
+    burst(f);
+    float p_true = goertzel_power_f32(&exact, buf);
+    float p_before = centre_power(&ft, f);
+    pulses(&ft, &params, f, 40);
+    float p_after = centre_power(&ft, f);
+    printf("offset %.1f Hz after %u retunes, centre %.1f dB -> %.2f dB of the tone\n", ft.offset_hz,
+           ft.retunes, 10 * log10f(p_before / p_true), 10 * log10f(p_after / p_true));
+    RUN("+2.5 kHz found to 10 Hz", fabsf(ft.offset_hz - 2500) < 10);
+    RUN("power recovered to 0.05 dB", fabsf(10 * log10f(p_after / p_true)) < 0.05f);
+    RUN("tuned centre is the estimate", fabsf(ft.tuned_hz - freq_hz(&ft)) < params.retune_hz);
+
+    freq_init(&ft, &params, F0, FS, N);
+    pulses(&ft, &params, F0 - 700, 40);
+    RUN("-700 Hz found to 10 Hz", fabsf(ft.offset_hz + 700) < 10);
+
+    //
+    // 3) On nominal nothing moves, retunes only every retune_pulses
+    //
+    freq_init(&ft, &params, F0, FS, N);
+    pulses(&ft, &params, F0, 10);
+    RUN("on nominal stays", fabsf(ft.offset_hz) < 5 && ft.retunes == 0);
+
+    freq_tracker ft2;
+    freq_params slow = params;
+    slow.retune_pulses = 8;
+    freq_init(&ft2, &slow, F0, FS, N);
+    pulses(&ft2, &slow, F0 + 500, 7);
+    RUN("no retune before retune_pulses", ft2.retunes == 0 && ft2.tuned_hz == F0);
+    pulses(&ft2, &slow, F0 + 500, 1);
+    RUN("retuned after", ft2.retunes == 1 && ft2.tuned_hz > F0);
+
+    //
+    // 4) Search range is clamped
+    //
+    freq_params narrow = params;
+    narrow.max_offset_hz = 1000;
+    freq_init(&ft, &narrow, F0, FS, N);
+    pulses(&ft, &narrow, F0 + 2500, 40);
+    RUN("clamped to max_offset_hz", ft.offset_hz == 1000);
+
+    //
+    // 5) Without the window on a bin centred tone
+    //
+    RUN("rect offset centred", freq_rect_offset(0, 1, 0, 2) == 0.0f && freq_rect_offset(1, 0, 1, 2) == 0.0f);
+    float d = 0.3f;
+    float pp = (d / (2 - d)) * (d / (2 - d)), pm = (d / (2 + d)) * (d / (2 + d));
+    RUN("rect offset above", fabsf(freq_rect_offset(pm, 1, pp, 2) - d) < 1e-4f);
+    RUN("rect offset below", fabsf(freq_rect_offset(pp, 1, pm, 2) + d) < 1e-4f);
+
+    freq_params rect = params;
+    rect.rect_max_bins = 0.1f;
+    freq_init(&ft, &rect, F0, FS, N);
+    RUN("starts windowed", ft.rect_ok && !freq_rect(&ft));
+    pulses(&ft, &rect, F0, rect.retune_pulses);
+    RUN("on nominal drops the window", freq_rect(&ft) && ft.tuned_hz == F0);
+
+    // same power either way, same clip statistics as the windowing pass
+    dsp_complex z[FREQ_BINS];
+    dsp_clip_stats st_raw, st_win;
+    burst_raw(F0);
+    goertzel_bin_multibin_raw(ft.plans, FREQ_BINS, buf, 2048, rect_gain, &st_raw, z);
+    dsp_window_q15_stats(buf, window, N, 2048, &st_win);
+    float p_win = goertzel_power_f32(&ft.plans[FREQ_CENTRE], buf);
+    printf("unwindowed %.1f, flattop %.1f, side bins %.2g\n", dsp_power(z[FREQ_CENTRE]), p_win,
+           dsp_power(z[0]) / dsp_power(z[FREQ_CENTRE]));
+    RUN("power matches the flattop", fabsf(10 * log10f(dsp_power(z[FREQ_CENTRE]) / p_win)) < 0.05f);
+    RUN("side bins on the nulls", dsp_power(z[0]) < 1e-4f * dsp_power(z[FREQ_CENTRE]));
+    RUN("stats match", st_raw.min == st_win.min && st_raw.max == st_win.max && st_raw.sum == st_win.sum
+        && st_raw.clipped == st_win.clipped);
+
+    pulses(&ft, &rect, F0 + 30, 10);
+    RUN("small offset stays unwindowed", freq_rect(&ft) && fabsf(ft.offset_hz - 30) < 5);
+
+    // a pulse off by more than rect_max_bins puts the window back at once,
+    // then tracking carries on as before
+    pulses(&ft, &rect, F0 + 600, 1);
+    RUN("falls back to the flattop", !freq_rect(&ft));
+    pulses(&ft, &rect, F0 + 600, 40);
+    printf("offset %.1f Hz after %u retunes\n", ft.offset_hz, ft.retunes);
+    RUN("+600 Hz found windowed", !freq_rect(&ft) && fabsf(ft.offset_hz - 600) < 10);
+
+    // and comes back when the beacon does
+    pulses(&ft, &rect, F0, 40);
+    RUN("back on nominal unwindowed", freq_rect(&ft) && ft.tuned_hz == F0);
+
+    // off centre nominal never drops the window
+    freq_init(&ft, &rect, F0 + 400, FS, N);
+    RUN("off centre nominal stays windowed", !ft.rect_ok);
+
+    printf("ALL TESTS PASSED\n");
+    return 0;
+}
@@ -4,6 +4,8 @@
 #include <math.h>
 #include "guidance.h"
 
+#define PI_TEST 3.14159265f
+
 // Convenience macro for succinct PASS/FAIL reporting
 #define RUN(desc, cond) do {                                           \
     if (!(cond)) {                                                     \
@@ -134,7 +136,8 @@ int main(void) {
         gbufx[0] = 1.0f;  gbufy[0] = 0.0f;
         guidance_step(gbufx, gbufy, 0, 0, &st, &p);
 
-        float perp = tanf(0.5f) * 1.0f;
+        // power across the heading for a field at 0.5 rad
+        float perp = tanf(0.5f) * tanf(0.5f);
         gbufx[0] = 1.0f;  gbufy[0] = perp;
         d = guidance_step(gbufx, gbufy, 0, 0, &st, &p);
         RUN("straight at fwd_thresh boundary", d == STRAIGHT_AHEAD);
@@ -207,6 +210,82 @@ int main(void) {
         guidance_state_free(&st);
     }
 
+    //
+    // 8) Signed cross term picks the side directly, no hunting
+    //
+    {
+        GuidanceParams p = {
+            .buf_size      = 1,
+            .hist_size     = 3,
+            .drop_steps    = 100,
+            .reverse_cd    = 1,
+            .fwd_thresh    = 0.5f,
+            .min_valid_mag = 0.0f
+        };
+        GuidanceState st;
+        guidance_state_init(&st, &p);
+
+        gbufx[0] = 1.0f;  gbufy[0] = 1.0f;
+        guidance_step_signed(gbufx, gbufy, 0, 0, 1.0f, &st, &p);  // seeds
+
+        // worsening ratio would flip the unsigned version, sign holds the side
+        int ok = 1;
+        for (int i = 0; i < 5; i++) {
+            gbufx[0] = 1.0f - 0.1f * i;  gbufy[0] = 1.0f;
+            if (guidance_step_signed(gbufx, gbufy, 0, 0, -0.5f, &st, &p) != TURN_RIGHT)
+                ok = 0;
+        }
+        RUN("negative cross term turns right every step", ok);
+
+        d = guidance_step_signed(gbufx, gbufy, 0, 0, 0.5f, &st, &p);
+        RUN("positive cross term turns left", d == TURN_LEFT);
+
+        gbufx[0] = 1.0f;  gbufy[0] = 0.1f;
+        d = guidance_step_signed(gbufx, gbufy, 0, 0, -0.5f, &st, &p);
+        RUN("signed straight inside fwd_thresh", d == STRAIGHT_AHEAD);
+
+        guidance_state_free(&st);
+    }
+
+    //
+    // 9) Extended output: signed heading correction and confidence
+    //
+    {
+        GuidanceParams p = {
+            .buf_size      = 1,
+            .hist_size     = 3,
+            .drop_steps    = 100,
+            .reverse_cd    = 1,
+            .fwd_thresh    = 0.5f,
+            .min_valid_mag = 1.0f
+        };
+        GuidanceState st;
+        guidance_state_init(&st, &p);
+
+        float cross = -1.0f;
+        gbufx[0] = 0.5f;  gbufy[0] = 0.5f;
+        GuidanceOutput o = guidance_step_ext(gbufx, gbufy, 0, 0, &cross, &st, &p);
+        RUN("weak sample has no confidence", o.confidence == 0.0f && o.heading_corr == 0.0f);
+
+        // powers of a field 4 along and 3 across the heading
+        gbufx[0] = 16.0f;  gbufy[0] = 9.0f;
+        guidance_step_ext(gbufx, gbufy, 0, 0, &cross, &st, &p);  // seeds
+        o = guidance_step_ext(gbufx, gbufy, 0, 0, &cross, &st, &p);
+        RUN("correction is the signed field angle", fabsf(o.heading_corr + atan2f(3.0f, 4.0f)) < 1e-5f);
+        RUN("legacy direction alongside", o.dir == TURN_RIGHT);
+        RUN("confidence from signal margin", fabsf(o.confidence - (1.0f - 1.0f / 25.0f)) < 1e-5f);
+
+        gbufx[0] = 4.0f;  gbufy[0] = 0.2f;
+        cross = 1.0f;
+        o = guidance_step_ext(gbufx, gbufy, 0, 0, &cross, &st, &p);
+        RUN("small correction inside fwd_thresh", o.dir == STRAIGHT_AHEAD && o.heading_corr > 0.0f);
+
+        o = guidance_step_ext(gbufx, gbufy, 0, 0, NULL, &st, &p);
+        RUN("unknown side halves confidence", o.confidence < 0.5f);
+
+        guidance_state_free(&st);
+    }
+
     printf("ALL TESTS PASSED\n");
     return 0;
 }
@@ -0,0 +1,95 @@
+// tests/pf_test.c
+#include <stdio.h>
+#include <math.h>
+#include "pf.h"
+
+// Convenience macro for succinct PASS/FAIL reporting
+#define RUN(desc, cond) do {                                           \
+    if (!(cond)) {                                                     \
+        fprintf(stderr, "[FAIL] %s\n", desc);                         \
+        return 1;                                                      \
+    } else {                                                           \
+        printf("[PASS] %s\n", desc);                                  \
+    }                                                                  \
+} while (0)
+
+#define PI_TEST 3.14159265f
+
+static pf_filter pf;
+
+// horizontal field of a buried dipole with axis at angle a, searcher frame
+static void field(float bx_pos, float by_pos, float depth, float a, float *bpar, float *bperp) {
+    float vx = -bx_pos, vy = -by_pos;
+    float r2 = vx * vx + vy * vy + depth * depth;
+    float r5 = r2 * r2 * sqrtf(r2);
+    float md = cosf(a) * vx + sinf(a) * vy;
+    *bpar = (3 * md * vx - r2 * cosf(a)) / r5;
+    *bperp = (3 * md * vy - r2 * sinf(a)) / r5;
+}
+
+int main(void) {
+    pf_params p = {
+        .moment      = 1.0f,
+        .depth_m     = 1.0f,
+        .range_min_m = 0.5f,
+        .range_max_m = 60.0f,
+        .step_m      = 1.0f,
+        .pos_sigma_m = 0.0f,
+        .turn_sigma  = 0.0f,
+        .mag_sigma   = 0.2f,
+        .ang_sigma   = 0.2f
+    };
+
+    //
+    // 1) Motion: turn then step, particles move the other way
+    //
+    pf_init(&pf, 1);
+    RUN("no estimate before the first reading", pf_get_estimate(&pf).range_m == 0.0f);
+    pf_update(&pf, &p, 1e-3f, 0.0f, 0.0f);
+    for (int i = 0; i < PF_NUM; i++) {
+        pf.x[i] = (int16_t)(5 * PF_POS_Q);
+        pf.y[i] = 0;
+        pf.phi[i] = 0;
+        pf.w[i] = 1.0f / PF_NUM;
+    }
+    pf_predict(&pf, &p, PI_TEST / 2);
+    pf_estimate e = pf_get_estimate(&pf);
+    RUN("turn left then step puts the beacon behind right", fabsf(e.bearing - atan2f(-5.0f, -1.0f)) < 0.01f);
+    RUN("step closes the range", fabsf(e.range_m - sqrtf(26.0f)) < 0.01f);
+    RUN("axis turns with the searcher", pf.phi[0] == 49152);
+
+    //
+    // 2) Walking past a beacon, the range converges
+    //
+    float bx = 12.0f, by = 4.0f, axis = 0.4f;
+    p.pos_sigma_m = 0.3f;
+    p.turn_sigma = 0.05f;
+    int ok = 1;
+    float w_sum = 0;
+    pf_init(&pf, 7);
+    for (int k = 0; k < 10; k++) {
+        float bpar, bperp;
+        field(bx, by, p.depth_m, axis, &bpar, &bperp);
+        pf_update(&pf, &p, bpar * bpar, bperp * bperp, bpar * bperp);
+        pf_predict(&pf, &p, 0.0f);
+        bx -= p.step_m;
+    }
+    e = pf_get_estimate(&pf);
+    for (int i = 0; i < PF_NUM; i++) {
+        w_sum += pf.w[i];
+        if (!(pf.w[i] >= 0)) ok = 0;
+    }
+    RUN("weights stay normalised", ok && fabsf(w_sum - 1.0f) < 1e-3f);
+    RUN("range within 15%", fabsf(e.range_m - sqrtf(bx * bx + by * by)) < 0.15f * sqrtf(bx * bx + by * by));
+    RUN("bearing within 20 degrees", fabsf(e.bearing - atan2f(by, bx)) < 0.35f);
+    RUN("updates counted", pf.updates == 10);
+
+    //
+    // 3) Zero power readings are ignored
+    //
+    pf_update(&pf, &p, 0.0f, 0.0f, 0.0f);
+    RUN("empty reading skipped", pf.updates == 10);
+
+    printf("ALL TESTS PASSED\n");
+    return 0;
+}
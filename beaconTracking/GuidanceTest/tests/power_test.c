@@ -0,0 +1,117 @@
+// tests/power_test.c
+#include <stdio.h>
+#include <math.h>
+#include "power.h"
+
+// Convenience macro for succinct PASS/FAIL reporting
+#define RUN(desc, cond) do {                                           \
+    if (!(cond)) {                                                     \
+        fprintf(stderr, "[FAIL] %s\n", desc);                         \
+        return 1;                                                      \
+    } else {                                                           \
+        printf("[PASS] %s\n", desc);                                  \
+    }                                                                  \
+} while (0)
+
+#define N 200
+
+int main(void) {
+    power_smoother ps;
+    float in[N];
+    unsigned seed = 7;
+    for (int i = 0; i < N; i++) {
+        seed = seed * 1103515245u + 12345u;
+        in[i] = 1000.0f + (float)((seed >> 16) % 200);
+    }
+
+    //
+    // 1) Default config matches the old boxcar of 5 bursts, averaged every 5
+    //
+    smooth_cfg box = {
+        .burst = {.mode = SMOOTH_BOXCAR, .len = POWER_BUF_SIZE},
+        .guide = {.mode = SMOOTH_NONE,   .len = 1},
+        .decim = POWER_BUF_SIZE
+    };
+    RUN("valid config accepted", power_smoother_init(&ps, &box));
+    int ok_rate = 1, ok_mean = 1;
+    for (int i = 0; i < N; i++) {
+        int ready = power_smoother_push(&ps, in[i]);
+        if (ready != ((i + 1) % POWER_BUF_SIZE == 0)) ok_rate = 0;
+        if (ready) {
+            float sum = 0;
+            for (int j = i - POWER_BUF_SIZE + 1; j <= i; j++) sum += in[j];
+            if (fabsf(ps.guide_out - sum / POWER_BUF_SIZE) > 1e-3f) ok_mean = 0;
+        }
+    }
+    RUN("guidance output every decim bursts", ok_rate);
+    RUN("boxcar output equals block average", ok_mean);
+
+    //
+    // 2) EMA step response reaches 1 - 1/e after tau samples
+    //
+    smooth_cfg ema = {
+        .burst = {.mode = SMOOTH_EMA,  .tau = 10.0f},
+        .guide = {.mode = SMOOTH_NONE, .len = 1},
+        .decim = 1
+    };
+    power_smoother_init(&ps, &ema);
+    power_smoother_push(&ps, 0.0f);
+    for (int i = 0; i < 10; i++) power_smoother_push(&ps, 1.0f);
+    RUN("EMA time constant", fabsf(ps.burst_out - (1.0f - expf(-1.0f))) < 1e-4f);
+    RUN("EMA output at burst and guidance rate", ps.burst_out == ps.guide_out);
+
+    //
+    // 3) Integrate-and-dump at guidance rate holds between dumps
+    //
+    smooth_cfg cic = {
+        .burst = {.mode = SMOOTH_NONE, .len = 1},
+        .guide = {.mode = SMOOTH_CIC,  .len = 3},
+        .decim = 2
+    };
+    power_smoother_init(&ps, &cic);
+    for (int i = 1; i <= 6; i++) power_smoother_push(&ps, (float)i);
+    // guidance stage sees 2, 4, 6
+    RUN("CIC dump is the mean of its inputs", fabsf(ps.guide_out - 4.0f) < 1e-6f);
+    for (int i = 7; i <= 10; i++) power_smoother_push(&ps, (float)i);
+    RUN("CIC holds between dumps", fabsf(ps.guide_out - 4.0f) < 1e-6f);
+    RUN("burst rate output passes through", ps.burst_out == 10.0f);
+
+    //
+    // 4) Long run at a large level: the running sum does not drift off the
+    //    mean of the last len inputs
+    //
+    power_smoother_init(&ps, &box);
+    for (int r = 0; r < 2000; r++) {
+        for (int i = 0; i < N; i++) power_smoother_push(&ps, 1e6f + in[i]);
+    }
+    float sum = 0;
+    for (int j = N - POWER_BUF_SIZE; j < N; j++) sum += 1e6f + in[j];
+    RUN("boxcar holds the mean over a long run", fabsf(ps.burst_out - sum / POWER_BUF_SIZE) < 0.1f);
+
+    //
+    // 5) Oversized boxcar is reported and clamped to the stage storage
+    //
+    smooth_cfg big = {
+        .burst = {.mode = SMOOTH_BOXCAR, .len = 1000},
+        .guide = {.mode = SMOOTH_NONE,   .len = 1},
+        .decim = 1
+    };
+    RUN("oversized boxcar reported", !power_smoother_init(&ps, &big));
+    RUN("boxcar length clamped", ps.burst.cfg.len == SMOOTH_MAX_BOXCAR);
+
+    //
+    // 6) Bursts averaged per guidance output, for the noise gate
+    //
+    smooth_cfg two = box;
+    two.guide.mode = SMOOTH_BOXCAR;
+    two.guide.len = 4;
+    smooth_cfg overlap = two;
+    overlap.decim = 2;
+    RUN("default spans its boxcar", power_smoother_span(&box) == POWER_BUF_SIZE);
+    RUN("stages multiply", power_smoother_span(&two) == 4 * POWER_BUF_SIZE);
+    RUN("overlapping boxcars share bursts", power_smoother_span(&overlap) == POWER_BUF_SIZE + 3 * 2);
+    RUN("clamped boxcar spans its storage", power_smoother_span(&big) == SMOOTH_MAX_BOXCAR);
+
+    printf("ALL TESTS PASSED\n");
+    return 0;
+}
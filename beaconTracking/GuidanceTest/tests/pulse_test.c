@@ -0,0 +1,97 @@
+// tests/pulse_test.c
+#include <stdio.h>
+#include <math.h>
+#include "pulse.h"
+
+// Convenience macro for succinct PASS/FAIL reporting
+#define RUN(desc, cond) do {                                           \
+    if (!(cond)) {                                                     \
+        fprintf(stderr, "[FAIL] %s\n", desc);                         \
+        return 1;                                                      \
+    } else {                                                           \
+        printf("[PASS] %s\n", desc);                                  \
+    }                                                                  \
+} while (0)
+
+#define BURST_MS  10
+#define ON_MS     70
+#define PERIOD_MS 470
+
+static unsigned seed = 3;
+
+// noise floor around 100, beacon pulses 30x stronger
+static float burst_power(unsigned t, int beacon)
+{
+    seed = seed * 1103515245u + 12345u;
+    float p = 70.0f + (float)((seed >> 16) % 60);
+    // first pulse starts 200 ms in
+    if (beacon && t >= 200 && (t - 200) % PERIOD_MS < ON_MS)
+        p += 3000.0f;
+    return p;
+}
+
+int main(void) {
+    const pulse_params params = {
+        .on_ratio      = 4.0f,
+        .off_ratio     = 2.0f,
+        .floor_alpha   = 0.05f,
+        .min_period_ms = 100,
+        .max_period_ms = 2000,
+        .period_tol    = 0.15f,
+        .lock_count    = 2,
+        .guard_ms      = 2 * BURST_MS,
+        .miss_count    = 3
+    };
+    pulse_detector pd;
+    pulse_init(&pd);
+
+    //
+    // 1) Learn the pulse train
+    //
+    unsigned t = 0;
+    int rises = 0;
+    for (; t < 200 + 4 * PERIOD_MS; t += BURST_MS) {
+        if (pulse_update(&pd, &params, t, burst_power(t, 1)) == PULSE_RISE)
+            rises++;
+    }
+    RUN("rising edges found", rises == 4);
+    RUN("locked after a few pulses", pd.locked);
+    RUN("period learned", fabsf(pd.period - PERIOD_MS) < BURST_MS);
+    RUN("on-time learned", fabsf(pd.on_time - ON_MS) <= BURST_MS);
+
+    //
+    // 2) Gating keeps every on-pulse burst and skips most of the off-time
+    //
+    int skipped = 0, total = 0, lost = 0, forwarded = 0;
+    unsigned end = t + 20 * PERIOD_MS;
+    for (; t < end; t += BURST_MS) {
+        float p = burst_power(t, 1);
+        int in_pulse = (t - 200) % PERIOD_MS < ON_MS;
+        total++;
+        if (!pulse_expect(&pd, &params, t)) {
+            skipped++;
+            if (in_pulse) lost++;
+            continue;
+        }
+        if (pulse_is_on(pulse_update(&pd, &params, t, p)))
+            forwarded++;
+    }
+    RUN("no on-pulse burst skipped", lost == 0);
+    RUN("most of the off-time skipped", skipped > total * 6 / 10);
+    RUN("all pulse bursts forwarded", forwarded == 20 * ON_MS / BURST_MS);
+    RUN("still locked", pd.locked);
+
+    //
+    // 3) Beacon gone, lock drops and scanning resumes
+    //
+    end = t + 5 * PERIOD_MS;
+    for (; t < end; t += BURST_MS) {
+        if (pulse_expect(&pd, &params, t))
+            pulse_update(&pd, &params, t, burst_power(t, 0));
+    }
+    RUN("lock lost without pulses", !pd.locked);
+    RUN("scanning after lock loss", pulse_expect(&pd, &params, t));
+
+    printf("ALL TESTS PASSED\n");
+    return 0;
+}
@@ -0,0 +1,61 @@
+// tests/range_test.c
+#include <stdio.h>
+#include <math.h>
+#include "range.h"
+#include "range_cal.h"
+
+// Convenience macro for succinct PASS/FAIL reporting
+#define RUN(desc, cond) do {                                           \
+    if (!(cond)) {                                                     \
+        fprintf(stderr, "[FAIL] %s\n", desc);                         \
+        return 1;                                                      \
+    } else {                                                           \
+        printf("[PASS] %s\n", desc);                                  \
+    }                                                                  \
+} while (0)
+
+int main(void) {
+    //
+    // 1) Table is monotonic, distance falls as power rises
+    //
+    int ok = 1;
+    for (unsigned i = 1; i < RANGE_CAL_LEN; i++) {
+        if (range_cal_cm[i] > range_cal_cm[i - 1]) ok = 0;
+    }
+    RUN("table monotonic", ok);
+
+    //
+    // 2) Lookup follows the model to within half a table step (1%) and
+    //    the cm rounding
+    //
+    ok = 1;
+    for (float r = 0.3f; r < 90.0f; r *= 1.07f) {
+        float pn = powf(r, -RANGE_CAL_EXPONENT);
+        if (fabsf(range_lookup(pn) - r) > 0.01f * r + 0.005f) ok = 0;
+    }
+    RUN("lookup within half a step of the model", ok);
+
+    //
+    // 3) Per channel gains: either channel alone gives the same distance
+    //
+    float r = 5.0f;
+    float px = powf(10.0f, RANGE_CAL_GAIN_DB_X / 10) * powf(r, -RANGE_CAL_EXPONENT);
+    float py = powf(10.0f, RANGE_CAL_GAIN_DB_Y / 10) * powf(r, -RANGE_CAL_EXPONENT);
+    RUN("X channel alone", fabsf(range_from_power(px, 0.0f) - r) < 0.015f * r);
+    RUN("Y channel alone", fabsf(range_from_power(0.0f, py) - r) < 0.015f * r);
+
+    float nx = px, ny = py, nxy = sqrtf(px * py);
+    range_normalise(&nx, &ny, &nxy);
+    RUN("normalised to field units", fabsf(nx - powf(r, -RANGE_CAL_EXPONENT)) < 1e-3f * nx
+                                     && fabsf(nxy - nx) < 1e-3f * nx);
+
+    //
+    // 4) Out of range readings clamp to the table ends
+    //
+    RUN("no signal reads as far", range_lookup(0.0f) == range_cal_cm[0] * 0.01f);
+    RUN("very weak clamps to far end", range_lookup(1e-30f) == range_cal_cm[0] * 0.01f);
+    RUN("very strong clamps to near end", range_lookup(1e30f) == range_cal_cm[RANGE_CAL_LEN - 1] * 0.01f);
+
+    printf("ALL TESTS PASSED\n");
+    return 0;
+}
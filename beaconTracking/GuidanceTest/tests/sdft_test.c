@@ -0,0 +1,143 @@
+// tests/sdft_test.c
+#include <stdio.h>
+#include <math.h>
+#include "sdft.h"
+
+// Convenience macro for succinct PASS/FAIL reporting
+#define RUN(desc, cond) do {                                           \
+    if (!(cond)) {                                                     \
+        fprintf(stderr, "[FAIL] %s\n", desc);                         \
+        return 1;                                                      \
+    } else {                                                           \
+        printf("[PASS] %s\n", desc);                                  \
+    }                                                                  \
+} while (0)
+
+#define PI_TEST 3.14159265358979
+#define FS 3600000.0
+#define F0 457000.0
+#define BURST 3600
+#define WIN 360
+#define HOP 90
+#define LONG 2000000
+
+static int16_t buf[BURST];
+static dsp_complex out[BURST];
+static float power[BURST];
+static unsigned seed = 3;
+
+static double noise(void) {
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 8) / 16777216.0 - 0.5;
+}
+
+// sample i of a stream: tone of amp counts on 2048, gated on [on, off)
+static int16_t sample(long i, double amp, long on, long off, double sigma) {
+    double v = 2048 + 2 * sigma * noise();
+    if (i >= on && i < off) {
+        v += amp * cos(2 * PI_TEST * F0 * i / FS + 0.4);
+    }
+    return (int16_t) lrint(v);
+}
+
+// the damped window the sliding DFT stands for, summed directly
+static dsp_complex direct(const int16_t *x, long end, double r) {
+    double re = 0, im = 0, w = 1;
+    double om = 2 * PI_TEST * F0 / FS;
+    for (long m = 0; m < WIN; m++) {
+        double v = x[end - m] - 2048;
+        re += w * v * cos(om * m);
+        im += w * v * sin(om * m);
+        w *= r;
+    }
+    dsp_complex z = {(float) (re * 2 / WIN), (float) (im * 2 / WIN)};
+    return z;
+}
+
+// sliding DFT powers of one burst, returns the count
+static uint32_t burst_powers(sdft_state *s) {
+    sdft_reset(s);
+    uint32_t m = sdft_process(s, buf, BURST, 2048, out);
+    for (uint32_t j = 0; j < m; j++) {
+        power[j] = dsp_power(out[j]);
+    }
+    return m;
+}
+
+int main(void) {
+    sdft_state s;
+    sdft_init(&s, F0, FS, WIN, HOP, SDFT_DAMPING);
+
+    //
+    // 1) Every output is the bin of its window
+    //
+    for (int i = 0; i < BURST; i++) {
+        buf[i] = sample(i, 800, 0, BURST, 50);
+    }
+    uint32_t m = sdft_process(&s, buf, BURST, 2048, out);
+    RUN("output count", m == sdft_outputs(BURST, WIN, HOP) && m == (BURST - WIN) / HOP + 1);
+    double err = 0;
+    for (uint32_t j = 0; j < m; j++) {
+        dsp_complex d = direct(buf, j * HOP + WIN - 1, SDFT_DAMPING);
+        err = fmax(err, hypot(out[j].re - d.re, out[j].im - d.im));
+    }
+    printf("largest error %.3g counts on |z| %.1f\n", err, sqrt(dsp_power(out[m - 1])));
+    RUN("matches the direct sum", err < 1e-3 * 800);
+    RUN("tone amplitude reads as |z|", fabs(sqrt(dsp_power(out[m - 1])) / 800 - 1) < 0.02);
+
+    //
+    // 2) Stays accurate on a long stream
+    //
+    sdft_reset(&s);
+    static int16_t tail[BURST];
+    dsp_complex last = {0, 0};
+    for (long i = 0; i < LONG; i += BURST) {
+        for (int k = 0; k < BURST; k++) {
+            tail[k] = sample(i + k, 800, 0, LONG, 50);
+        }
+        m = sdft_process(&s, tail, BURST, 2048, out);
+        last = out[m - 1];
+    }
+    dsp_complex d = direct(tail, BURST - 1, SDFT_DAMPING);
+    err = hypot(last.re - d.re, last.im - d.im);
+    printf("after %d samples error %.3g counts\n", LONG, err);
+    RUN("no drift after 2M samples", err < 1e-2 * 800);
+
+    //
+    // 3) Pulse edges inside a burst, to a fraction of a hop
+    //
+    double worst = 0;
+    for (long e = WIN; e <= BURST - WIN; e += 97) {
+        for (int i = 0; i < BURST; i++) buf[i] = sample(i, 300, e, BURST, 40);
+        m = burst_powers(&s);
+        float rise = sdft_edge(power, m, WIN, HOP, true);
+        for (int i = 0; i < BURST; i++) buf[i] = sample(i, 300, 0, e, 40);
+        m = burst_powers(&s);
+        float fall = sdft_edge(power, m, WIN, HOP, false);
+        worst = fmax(worst, fmax(fabs(rise - e), fabs(fall - e)));
+    }
+    printf("worst edge error %.1f samples (%.1f us), hop %d\n", worst, worst / FS * 1e6, HOP);
+    RUN("edges to a quarter hop", worst < HOP / 4);
+
+    //
+    // 4) No edge in the burst, or the wrong way, reads -1
+    //
+    for (int i = 0; i < BURST; i++) buf[i] = sample(i, 300, 0, BURST, 40);
+    m = burst_powers(&s);
+    RUN("steady tone has no edge", sdft_edge(power, m, WIN, HOP, true) < 0 && sdft_edge(power, m, WIN, HOP, false) < 0);
+    for (int i = 0; i < BURST; i++) buf[i] = sample(i, 300, 2000, BURST, 40);
+    m = burst_powers(&s);
+    RUN("rise is not a fall", sdft_edge(power, m, WIN, HOP, false) < 0);
+    for (int i = 0; i < BURST; i++) buf[i] = sample(i, 300, 100, BURST, 40);
+    m = burst_powers(&s);
+    RUN("rise in the first window not placed", sdft_edge(power, m, WIN, HOP, true) < 0);
+    for (int i = 0; i < BURST; i++) buf[i] = sample(i, 300, BURST - 200, BURST, 40);
+    m = burst_powers(&s);
+    RUN("rise in the last window not placed", sdft_edge(power, m, WIN, HOP, true) < 0);
+    for (int i = 0; i < BURST; i++) buf[i] = sample(i, 300, 0, 200, 40);
+    m = burst_powers(&s);
+    RUN("fall in the first window not placed", sdft_edge(power, m, WIN, HOP, false) < 0);
+
+    printf("ALL TESTS PASSED\n");
+    return 0;
+}
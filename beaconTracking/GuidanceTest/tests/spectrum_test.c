@@ -0,0 +1,61 @@
+// tests/spectrum_test.c
+#include <stdio.h>
+#include <math.h>
+#include "spectrum.h"
+
+// Convenience macro for succinct PASS/FAIL reporting
+#define RUN(desc, cond) do {                                           \
+    if (!(cond)) {                                                     \
+        fprintf(stderr, "[FAIL] %s\n", desc);                         \
+        return 1;                                                      \
+    } else {                                                           \
+        printf("[PASS] %s\n", desc);                                  \
+    }                                                                  \
+} while (0)
+
+#define PI_TEST 3.14159265f
+#define FS ACQ_FS_HZ
+#define F0 ACQ_IF_HZ
+
+static int16_t window[BUF_SIZE];
+static int16_t bufx[BUF_SIZE];
+static int16_t bufy[BUF_SIZE];
+
+static uint32_t band_of(const spec_result *r, float f) {
+    return (uint32_t) (f / r->band_hz);
+}
+
+int main(void) {
+    for (int i = 0; i < BUF_SIZE; i++) {
+        float t = 2 * PI_TEST * i / (BUF_SIZE - 1);
+        float w = 0.21557895f - 0.41663158f * cosf(t) + 0.277263158f * cosf(2 * t)
+                  - 0.083578947f * cosf(3 * t) + 0.006947368f * cosf(4 * t);
+        // q15 like the burst's flattop table
+        window[i] = (int16_t) lrintf(w * 32767);
+    }
+
+    // carrier near full scale, -0.92 dB, an interferer 26 dB under it, the
+    // peaks together stay inside the 12 bit range
+    float fi = 0.4f * FS;
+    for (int i = 0; i < BUF_SIZE; i++) {
+        bufx[i] = (int16_t) (2048 + lrintf(1843 * cosf(2 * PI_TEST * F0 * i / FS)
+                                           + 92 * cosf(2 * PI_TEST * fi * i / FS + 1)));
+    }
+
+    spec_init();
+    spec_result r;
+    spec_run(bufx, bufy, window, BUF_SIZE, 2048, FS, &r);
+
+    printf("%d point FFT, %.0f Hz bands, peak %.0f Hz at %.2f dB\n", SPEC_N, r.band_hz, r.peak_hz, r.peak_db);
+    printf("carrier band %.2f dB, interferer band %.2f dB, quiet band %.2f dB\n", r.db[band_of(&r, F0)],
+           r.db[band_of(&r, fi)], r.db[band_of(&r, 0.15f * FS)]);
+
+    RUN("bands span to fs/2", fabsf(r.band_hz * SPEC_BANDS - FS / 2) < 1);
+    RUN("peak at the carrier", fabsf(r.peak_hz - F0) <= FS / SPEC_N);
+    RUN("carrier at -0.9 dBFS", fabsf(r.peak_db + 0.92f) < 0.5f);
+    RUN("interferer at -27 dBFS", fabsf(r.db[band_of(&r, fi)] + 26.95f) < 1.0f);
+    RUN("quiet band well down", r.db[band_of(&r, 0.15f * FS)] < -60);
+
+    printf("ALL TESTS PASSED\n");
+    return 0;
+}
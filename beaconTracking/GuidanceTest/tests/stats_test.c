@@ -0,0 +1,79 @@
+// tests/stats_test.c
+#include <stdio.h>
+#include <math.h>
+#include "stats.h"
+
+// Convenience macro for succinct PASS/FAIL reporting
+#define RUN(desc, cond) do {                                           \
+    if (!(cond)) {                                                     \
+        fprintf(stderr, "[FAIL] %s\n", desc);                         \
+        return 1;                                                      \
+    } else {                                                           \
+        printf("[PASS] %s\n", desc);                                  \
+    }                                                                  \
+} while (0)
+
+#define WIN 7
+#define N   500
+
+int main(void) {
+    float buf[WIN];
+    uint32_t maxq[WIN], minq[WIN];
+    stats_window w;
+
+    //
+    // 1) Empty and partially filled window
+    //
+    stats_window_init(&w, buf, maxq, minq, WIN);
+    RUN("empty mean is 0", stats_window_mean(&w) == 0.0f);
+
+    stats_window_push(&w, 3.0f);
+    stats_window_push(&w, 5.0f);
+    RUN("mean of partial window", fabsf(stats_window_mean(&w) - 4.0f) < 1e-6f);
+    RUN("max of partial window", stats_window_max(&w) == 5.0f);
+    RUN("min of partial window", stats_window_min(&w) == 3.0f);
+    RUN("last sample", stats_window_last(&w) == 5.0f);
+
+    //
+    // 2) Sliding sum/max/min match a brute force rescan
+    //
+    stats_window_init(&w, buf, maxq, minq, WIN);
+    float hist[N];
+    unsigned seed = 1;
+    int ok_sum = 1, ok_max = 1, ok_min = 1;
+    for (int i = 0; i < N; i++) {
+        seed = seed * 1103515245u + 12345u;
+        // include repeats so ties are exercised
+        hist[i] = (float)((seed >> 16) % 50);
+        stats_window_push(&w, hist[i]);
+
+        int first = i - WIN + 1 < 0 ? 0 : i - WIN + 1;
+        double sum = 0;
+        float mx = hist[first], mn = hist[first];
+        for (int j = first; j <= i; j++) {
+            sum += hist[j];
+            if (hist[j] > mx) mx = hist[j];
+            if (hist[j] < mn) mn = hist[j];
+        }
+        if (fabs(w.sum - sum) > 1e-3) ok_sum = 0;
+        if (stats_window_max(&w) != mx) ok_max = 0;
+        if (stats_window_min(&w) != mn) ok_min = 0;
+    }
+    RUN("running sum matches rescan", ok_sum);
+    RUN("sliding max matches rescan", ok_max);
+    RUN("sliding min matches rescan", ok_min);
+
+    //
+    // 3) Compensated sum doesn't drift over a long run of awkward values
+    //
+    stats_window_init(&w, buf, maxq, minq, WIN);
+    for (int i = 0; i < 1000000; i++)
+        stats_window_push(&w, (i & 1) ? 1e6f : 0.1f);
+    double expect = 0;
+    for (int j = 0; j < WIN; j++)
+        expect += buf[j];
+    RUN("no drift after 1e6 pushes", fabs(w.sum - expect) / expect < 1e-6);
+
+    printf("ALL TESTS PASSED\n");
+    return 0;
+}
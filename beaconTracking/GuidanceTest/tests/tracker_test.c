@@ -0,0 +1,368 @@
+// tests/tracker_test.c
+#include <stdio.h>
+#include <math.h>
+#include "acq.h"
+#include "coherent.h"
+#include "tracker.h"
+
+// Convenience macro for succinct PASS/FAIL reporting
+#define RUN(desc, cond) do {                                           \
+    if (!(cond)) {                                                     \
+        fprintf(stderr, "[FAIL] %s\n", desc);                         \
+        return 1;                                                      \
+    } else {                                                           \
+        printf("[PASS] %s\n", desc);                                  \
+    }                                                                  \
+} while (0)
+
+#define BURST_MS 10
+#define ON_MS    70
+
+// two transmitters with different periods, offsets and strengths
+typedef struct { unsigned start, period; float px, py; } beacon;
+static const beacon beacons[2] = {
+    {100, 470, 4000.0f, 1000.0f},
+    {300, 530, 150.0f,  600.0f},
+};
+
+static int beacon_on(const beacon *b, unsigned t)
+{
+    return t >= b->start && (t - b->start) % b->period < ON_MS;
+}
+
+// complex gaussian noise of the given power, Box-Muller
+static unsigned gseed = 17;
+static dsp_complex cnoise(float power)
+{
+    gseed = gseed * 1103515245u + 12345u;
+    float u1 = ((gseed >> 8) + 1.0f) / 16777217.0f;
+    gseed = gseed * 1103515245u + 12345u;
+    float u2 = (gseed >> 8) / 16777216.0f;
+    float r = sqrtf(-power * logf(u1));
+    dsp_complex z = {r * cosf(6.2831853f * u2), r * sinf(6.2831853f * u2)};
+    return z;
+}
+
+int main(void) {
+    const smooth_cfg smooth = {
+        .burst = {.mode = SMOOTH_BOXCAR, .len = POWER_BUF_SIZE},
+        .guide = {.mode = SMOOTH_NONE,   .len = 1},
+        .decim = POWER_BUF_SIZE
+    };
+    const GuidanceParams gp = {
+        .buf_size      = POWER_AVG_BUF_SIZE,
+        .hist_size     = POWER_AVG_BUF_SIZE,
+        .drop_steps    = 10,
+        .reverse_cd    = 40,
+        .fwd_thresh    = 3.14159265f / 8.0f,
+        .min_valid_mag = 4.0f
+    };
+    const tracker_params tp = {
+        .min_period_ms = 100,
+        .max_period_ms = 2000,
+        .period_tol    = 0.15f,
+        .amp_tol_db    = 6.0f,
+        .miss_count    = 3,
+        .smooth        = &smooth,
+        .guidance      = &gp
+    };
+    const pulse_params pp = {
+        .on_ratio      = 4.0f,
+        .off_ratio     = 2.0f,
+        .floor_alpha   = 0.05f,
+        .min_period_ms = 100,
+        .max_period_ms = 2000,
+        .period_tol    = 0.15f,
+        .lock_count    = 2,
+        .guard_ms      = 2 * BURST_MS,
+        .miss_count    = 3
+    };
+    pulse_detector pd;
+    static tracker tr;
+    pulse_init(&pd);
+    tracker_init(&tr, &tp);
+
+    //
+    // 1) Two interleaved pulse trains give two tracks
+    //
+    unsigned t = 0;
+    for (; t < 30000; t += BURST_MS) {
+        float px = 10.0f, py = 10.0f;
+        int on0 = beacon_on(&beacons[0], t), on1 = beacon_on(&beacons[1], t);
+        if (on0) { px += beacons[0].px; py += beacons[0].py; }
+        if (on1) { px += beacons[1].px; py += beacons[1].py; }
+        pulse_event ev = pulse_update(&pd, &pp, t, px + py);
+        tracker_push(&tr, &tp, t, ev, px, py, sqrtf(px * py), false);
+    }
+    RUN("two tracks", tracker_count(&tr) == 2);
+
+    // find which track is which by period
+    track *a = NULL, *b = NULL;
+    for (int k = 0; k < TRACK_MAX; k++) {
+        track *tk = &tr.tracks[k];
+        if (!tk->active) continue;
+        if (fabsf(tk->period - 470) < 15) a = tk;
+        if (fabsf(tk->period - 530) < 15) b = tk;
+    }
+    RUN("first period learned", a != NULL);
+    RUN("second period learned", b != NULL);
+
+    //
+    // 2) Each track averages only its own transmitter
+    //
+    RUN("strong track X power", fabsf(stats_window_last(&a->avgx) - 4010.0f) < 50.0f);
+    RUN("strong track Y power", fabsf(stats_window_last(&a->avgy) - 1010.0f) < 50.0f);
+    RUN("weak track X power", fabsf(stats_window_last(&b->avgx) - 160.0f) < 20.0f);
+    RUN("weak track Y power", fabsf(stats_window_last(&b->avgy) - 610.0f) < 20.0f);
+
+    //
+    // 3) Selection
+    //
+    track *first = tracker_selected(&tr);
+    RUN("a track is selected", first != NULL);
+    tracker_select_next(&tr);
+    RUN("select next switches track", tracker_selected(&tr) != first);
+    RUN("select by id", tracker_select(&tr, first->id) && tracker_selected(&tr) == first);
+
+    //
+    // 4) Transmitters switched off, tracks expire
+    //
+    for (unsigned end = t + 10000; t < end; t += BURST_MS) {
+        pulse_event ev = pulse_update(&pd, &pp, t, 20.0f);
+        tracker_push(&tr, &tp, t, ev, 10.0f, 10.0f, 10.0f, false);
+    }
+    RUN("tracks dropped", tracker_count(&tr) == 0);
+    RUN("nothing selected", tracker_selected(&tr) == NULL);
+
+    //
+    // 5) CFAR gate: a beacon under a fixed min_valid_mag is still guided to
+    //    when it stands out of the measured noise
+    //
+    GuidanceParams gp_high = gp;
+    gp_high.min_valid_mag = 1000.0f;
+    const cfar_params cp = {.window = 32, .rank = 24, .pfa = 1e-3f, .looks = 2};
+    tracker_params tp_fixed = tp, tp_cfar = tp;
+    tp_fixed.guidance = &gp_high;
+    tp_cfar.guidance = &gp_high;
+    tp_cfar.cfar = &cp;
+
+    static tracker tr_fixed, tr_cfar;
+    pulse_detector pd2;
+    pulse_init(&pd2);
+    tracker_init(&tr_fixed, &tp_fixed);
+    tracker_init(&tr_cfar, &tp_cfar);
+    unsigned seed = 3;
+    float conf_fixed = 0, conf_cfar = 0;
+    for (unsigned end = t + 20000; t < end; t += BURST_MS) {
+        // exponential noise power, mean 10 per channel
+        float nx, ny;
+        seed = seed * 1103515245u + 12345u;
+        nx = -10.0f * logf(((seed >> 8) + 1.0f) / 16777217.0f);
+        seed = seed * 1103515245u + 12345u;
+        ny = -10.0f * logf(((seed >> 8) + 1.0f) / 16777217.0f);
+        float px = nx, py = ny;
+        if (beacon_on(&beacons[1], t)) { px += 300.0f; py += 300.0f; }
+        pulse_event ev = pulse_update(&pd2, &pp, t, px + py);
+        if (tracker_push(&tr_fixed, &tp_fixed, t, ev, px, py, sqrtf(px * py), false) >= 0)
+            conf_fixed = tracker_selected(&tr_fixed)->out.confidence;
+        if (tracker_push(&tr_cfar, &tp_cfar, t, ev, px, py, sqrtf(px * py), false) >= 0)
+            conf_cfar = tracker_selected(&tr_cfar)->out.confidence;
+    }
+    RUN("noise floor measured between pulses", cfar_ready(&tr_cfar.noise));
+    RUN("threshold near the noise", cfar_threshold(&tr_cfar.noise) > 20.0f
+                                    && cfar_threshold(&tr_cfar.noise) < 200.0f);
+    RUN("fixed gate throws the beacon away", conf_fixed == 0.0f);
+    RUN("CFAR gate guides to it", conf_cfar > 0.5f);
+
+    //
+    // 6) Clipped bursts flag the track and halve its confidence
+    //
+    float conf_sat = 1.0f;
+    for (unsigned end = t + 5000; t < end; t += BURST_MS) {
+        int on = beacon_on(&beacons[1], t);
+        float px = 10.0f + (on ? 300.0f : 0.0f), py = px;
+        pulse_event ev = pulse_update(&pd2, &pp, t, px + py);
+        if (tracker_push(&tr_cfar, &tp_cfar, t, ev, px, py, px, on) >= 0)
+            conf_sat = tracker_selected(&tr_cfar)->out.confidence;
+    }
+    RUN("saturated pulse flags the track", tracker_selected(&tr_cfar)->saturated);
+    RUN("saturated confidence halved", conf_sat <= 0.5f);
+    for (unsigned end = t + 1000; t < end; t += BURST_MS) {
+        float px = 10.0f + (beacon_on(&beacons[1], t) ? 300.0f : 0.0f), py = px;
+        pulse_event ev = pulse_update(&pd2, &pp, t, px + py);
+        tracker_push(&tr_cfar, &tp_cfar, t, ev, px, py, px, false);
+    }
+    RUN("clean pulse clears the flag", !tracker_selected(&tr_cfar)->saturated);
+
+    //
+    // 7) A beacon whose pulse power sits under a single burst's gate: the
+    //    smoothed burst powers are gated on the factor for their mean, and
+    //    coherent pulse powers once the gate is scaled to their noise.
+    //    A single burst is too weak for the pulse detector here, the pulses
+    //    are timed from the envelope as a locked detector would predict them
+    //
+    tracker_params tp_coh = tp_cfar;
+    tp_coh.guidance = &gp;
+
+    // coherent and gate scaled, coherent with a single burst gate, smoothed
+    static tracker tr_coh, tr_one, tr_avg;
+    tracker_init(&tr_coh, &tp_coh);
+    tracker_init(&tr_one, &tp_coh);
+    tracker_init(&tr_avg, &tp_coh);
+    pulse_detector pd3;
+    pulse_init(&pd3);
+    coh_integrator ci;
+    float conf_coh = 0, conf_one = 0, conf_avg = 0;
+    float phase = 0;
+    for (unsigned end = t + 20000; t < end; t += BURST_MS) {
+        // bins with noise of power 10 per channel, the beacon adds 20
+        int on = beacon_on(&beacons[1], t);
+        dsp_complex x = cnoise(10.0f), y = cnoise(10.0f);
+        if (on) {
+            x.re += sqrtf(20.0f) * cosf(phase);  x.im += sqrtf(20.0f) * sinf(phase);
+            y.re += sqrtf(20.0f) * cosf(phase);  y.im += sqrtf(20.0f) * sinf(phase);
+        }
+        else {
+            phase += 1.0f;
+        }
+        float px = dsp_power(x), py = dsp_power(y), pxy = dsp_cross(x, y);
+        pulse_event ev = pulse_update(&pd3, &pp, t, on ? 200.0f : 20.0f);
+
+        // carrier at 0 Hz, the phase holds over the pulse as it would once
+        // the firmware has taken the carrier out
+        uint32_t cycles = t * 216000u;
+        if (ev == PULSE_RISE) coh_start(&ci, 0.0f, 216e6f, cycles);
+        if (pulse_is_on(ev)) {
+            coh_push(&ci, cycles, x, y);
+        }
+        else if (ev == PULSE_FALL) {
+            coh_result r = coh_finish(&ci);
+            tracker_pulse_power(&tr_coh, r.px, r.py, r.pxy, r.n);
+            tracker_pulse_power(&tr_one, r.px, r.py, r.pxy, 1);
+        }
+
+        if (tracker_push(&tr_coh, &tp_coh, t, ev, px, py, pxy, false) >= 0)
+            conf_coh = tracker_selected(&tr_coh)->out.confidence;
+        if (tracker_push(&tr_one, &tp_coh, t, ev, px, py, pxy, false) >= 0)
+            conf_one = tracker_selected(&tr_one)->out.confidence;
+        if (tracker_push(&tr_avg, &tp_coh, t, ev, px, py, pxy, false) >= 0)
+            conf_avg = tracker_selected(&tr_avg)->out.confidence;
+    }
+    float gate_one = tr_avg.coh_alpha * cfar_floor(&tr_avg.noise);
+    printf("gate %.1f single burst, %.1f smoothed, pulse power %.1f; confidence coherent %.2f, "
+           "single burst gate %.2f, smoothed %.2f\n", gate_one, cfar_threshold(&tr_avg.noise),
+           tracker_selected(&tr_avg)->amp, conf_coh, conf_one, conf_avg);
+    RUN("pulse power under the single burst gate", tracker_selected(&tr_avg)->amp < gate_one);
+    RUN("smoothed gate lower", cfar_threshold(&tr_avg.noise) < 0.7f * gate_one);
+    RUN("smoothed pulses guided", conf_avg > 0.0f);
+    RUN("single burst gate throws the coherent pulses away", conf_one == 0.0f);
+    RUN("scaled gate guides to the coherent pulses", conf_coh > 0.5f);
+
+    //
+    // 8) Two transmitters at 1000 and 1050 ms through the burst scheduler and
+    //    the pulse gate, as the firmware runs them: both stay tracked, and
+    //    the gating comes back once one of them stops
+    //
+    const beacon pair[2] = {
+        {100, 1000, 2000.0f, 500.0f},
+        {420, 1050, 100.0f,  300.0f},
+    };
+    static tracker tr2, tr_single;
+    pulse_detector pd_multi, pd_single;
+    acq_sched sched_multi, sched_single;
+    tracker_init(&tr2, &tp);
+    tracker_init(&tr_single, &tp);
+    pulse_init(&pd_multi);
+    pulse_init(&pd_single);
+    acq_init(&sched_multi);
+    acq_init(&sched_single);
+    unsigned min_multi = TRACK_MAX, missed_multi = 0, missed_single = 0;
+    for (unsigned t2 = 0; t2 < 60000; t2 += BURST_MS) {
+        float px = 10.0f, py = 10.0f;
+        bool on = false;
+        for (int k = 0; k < 2; k++) {
+            if (beacon_on(&pair[k], t2)) { px += pair[k].px; py += pair[k].py; on = true; }
+        }
+
+        // tracker aware gating
+        if (acq_burst_due(&sched_multi, t2) && tracker_expect(&tr2, &pd_multi, &pp, t2)) {
+            pulse_event ev = pulse_update(&pd_multi, &pp, t2, px + py);
+            tracker_push(&tr2, &tp, t2, ev, px, py, sqrtf(px * py), false);
+            acq_sync(&sched_multi, &pd_multi, &pp, tracker_count(&tr2));
+        } else if (on) {
+            missed_multi++;
+        }
+
+        // the detector's single train window alone
+        if (acq_burst_due(&sched_single, t2) && pulse_expect(&pd_single, &pp, t2)) {
+            pulse_event ev = pulse_update(&pd_single, &pp, t2, px + py);
+            tracker_push(&tr_single, &tp, t2, ev, px, py, sqrtf(px * py), false);
+            acq_sync(&sched_single, &pd_single, &pp, 1);
+        } else if (on) {
+            missed_single++;
+        }
+
+        if (t2 > 10000 && tracker_count(&tr2) < min_multi) min_multi = tracker_count(&tr2);
+    }
+    printf("pulse bursts skipped with one window: %u, with tracker gating: %u\n",
+           missed_single, missed_multi);
+    RUN("single train window skips pulses", missed_single > 0);
+    RUN("tracker gating skips none", missed_multi == 0);
+    RUN("both transmitters stay tracked", min_multi == 2);
+    int periods = 0;
+    for (int k = 0; k < TRACK_MAX; k++) {
+        const track *tk = &tr2.tracks[k];
+        if (tk->active && (fabsf(tk->period - 1000) < 20 || fabsf(tk->period - 1050) < 20)) periods++;
+    }
+    RUN("both periods learned", periods == 2);
+
+    // second transmitter stops: its track expires and the window gates again
+    sched_multi.bursts = 0;
+    sched_multi.skipped = 0;
+    for (unsigned t2 = 60000; t2 < 80000; t2 += BURST_MS) {
+        float px = 10.0f, py = 10.0f;
+        if (beacon_on(&pair[0], t2)) { px += pair[0].px; py += pair[0].py; }
+        if (acq_burst_due(&sched_multi, t2) && tracker_expect(&tr2, &pd_multi, &pp, t2)) {
+            pulse_event ev = pulse_update(&pd_multi, &pp, t2, px + py);
+            tracker_push(&tr2, &tp, t2, ev, px, py, sqrtf(px * py), false);
+            acq_sync(&sched_multi, &pd_multi, &pp, tracker_count(&tr2));
+        }
+    }
+    RUN("one track left", tracker_count(&tr2) == 1);
+    RUN("gating resumes", sched_multi.state == ACQ_LOCKED && sched_multi.skipped > sched_multi.bursts);
+
+    //
+    // 9) Rises placed inside the burst: a 1003 ms train seen on a 10 ms burst
+    //    grid sees its period wander by the grid, with the edge handed over
+    //    the period holds
+    //
+    const beacon odd = {7, 1003, 2000.0f, 500.0f};
+    static tracker tr_grid, tr_edge;
+    pulse_detector pd4;
+    tracker_init(&tr_grid, &tp);
+    tracker_init(&tr_edge, &tp);
+    pulse_init(&pd4);
+    float err_grid = 0, err_edge = 0;
+    for (unsigned t2 = 0; t2 < 40000; t2 += BURST_MS) {
+        // the burst that sees the rise starts up to a burst after it
+        float px = 10.0f, py = 10.0f;
+        if (beacon_on(&odd, t2) || beacon_on(&odd, t2 + BURST_MS - 1)) { px += odd.px; py += odd.py; }
+        pulse_event ev = pulse_update(&pd4, &pp, t2, px + py);
+        tracker_push(&tr_grid, &tp, t2, ev, px, py, sqrtf(px * py), false);
+        tracker_push(&tr_edge, &tp, t2, ev, px, py, sqrtf(px * py), false);
+        if (ev == PULSE_RISE) {
+            unsigned rise = t2 + BURST_MS - 1 - (t2 + BURST_MS - 1 - odd.start) % odd.period;
+            tracker_pulse_rise(&tr_edge, rise);
+        }
+        if (t2 > 10000) {
+            err_grid = fmaxf(err_grid, fabsf(tracker_selected(&tr_grid)->period - 1003.0f));
+            err_edge = fmaxf(err_edge, fabsf(tracker_selected(&tr_edge)->period - 1003.0f));
+        }
+    }
+    printf("period error up to %.2f ms on the burst grid, %.2f ms from the edges\n", err_grid, err_edge);
+    RUN("edge timed period holds", err_edge < 0.5f);
+    RUN("edges beat the burst grid", err_edge < 0.25f * err_grid);
+
+    printf("ALL TESTS PASSED\n");
+    return 0;
+}
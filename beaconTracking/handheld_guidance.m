@@ -1,6 +1,10 @@
 % handheld_guidance.m
 % Simulate a handheld receiver guiding a person to a beacon using only
 % the unsigned power readings from two orthogonal antennas:
+%
+% params.steering selects 'bangbang' (fixed max_turn, side found by trial,
+% like guidance_step()) or 'proportional' (turn by the signed angle to the
+% field line, side from the X/Y phase, like guidance_step_ext()).
 
 %% === Constants & Grid Setup ===
 mu0    = 4*pi*1e-7;           
@@ -24,6 +28,7 @@ params.reverse_cd    = 20;
 params.fwd_thresh    = pi/8;
 params.max_turn      = pi/6;
 params.step_size     = 0.5;
+params.steering      = 'proportional';
 
 % Rolling‐history buffer (seed below)
 state.history.buf = zeros(params.hist_size,1);
@@ -86,10 +91,14 @@ for k = 1:steps
     % 1) Sample two‐antenna powers
     Bx   = interp2(x,y,BxF,pos(1),pos(2),'linear',0);
     By   = interp2(x,y,ByF,pos(1),pos(2),'linear',0);
-    Bpar = abs(dot([Bx,By],heading));
+    Bpar_s = dot([Bx,By],heading);
     perp = [-heading(2), heading(1)];
-    Bperp= abs(dot([Bx,By],perp));
+    Bperp_s= dot([Bx,By],perp);
+    Bpar = abs(Bpar_s);
+    Bperp= abs(Bperp_s);
     mag  = sqrt(Bpar^2 + Bperp^2);
+    % X/Y cross term, its sign is the side of the field line
+    xy_cross = Bpar_s * Bperp_s;
 
     % 2) Update history & compute previous average
     avg_prev = state.sum_history / params.hist_size;
@@ -123,16 +132,22 @@ for k = 1:steps
     end
 
     % 4) Steering decision
+    ang = atan2(Bperp, Bpar);
     if state.reverse_lock
         if state.did_reverse
             turn = pi;               % do U‐turn once
             state.did_reverse = false;
+        elseif strcmp(params.steering, 'proportional')
+            % hold reversed heading along the field line
+            turn = sign_or_one(xy_cross) * ang;
         else
             turn = 0;                % hold reversed heading
         end
         sug_vec = [0, -1];
+    elseif strcmp(params.steering, 'proportional')
+        turn    = sign_or_one(xy_cross) * ang;
+        sug_vec = [-sin(turn), cos(turn)];
     else
-        ang = atan2(Bperp, Bpar);
         if abs(ang) <= params.fwd_thresh
             turn    = 0;
             sug_vec = [0, 1];
@@ -183,6 +198,14 @@ for k = 1:steps
     end
 end
 
+%% === sign helper, zero counts as positive ===
+function s = sign_or_one(v)
+    s = 1;
+    if v < 0
+        s = -1;
+    end
+end
+
 %% === rotate helper ===
 function v2 = rotate_vector(v, theta)
     R  = [cos(theta), -sin(theta); sin(theta), cos(theta)];
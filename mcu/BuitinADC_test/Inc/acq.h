@@ -0,0 +1,43 @@
+/*
+ * Pulse synchronous acquisition scheduler.
+ *
+ * Decides, from the SysTick handler, whether a burst slot is used. While
+ * scanning every slot is used. Once the pulse detector has locked, only the
+ * slots in a window around the predicted pulse are, and the ADC, DMA and CPU
+ * stay idle for the rest of the period. The detector learns one pulse train,
+ * so while more than one transmitter is tracked it keeps scanning.
+ *
+ * acq_sync() runs in the main loop and acq_burst_due() in the SysTick
+ * interrupt, so the caller must keep the interrupt out while syncing.
+ */
+
+#ifndef ACQ_H
+#define ACQ_H
+
+#include "pulse.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum
+{
+  ACQ_SCAN,     // no lock, burst every slot
+  ACQ_LOCKED    // burst only around the predicted pulse
+} acq_state;
+
+typedef struct
+{
+  acq_state state;
+  uint32_t last_rise;   // tick of the last rising edge
+  uint32_t period_ms;   // pulse period
+  uint32_t open_ms;     // window opens this long before the predicted rise
+  uint32_t close_ms;    // and closes this long after it
+  uint32_t lost_ms;     // time without a rise before going back to scanning
+  uint32_t bursts;      // slots used
+  uint32_t skipped;     // slots left idle
+} acq_sched;
+
+void acq_init(acq_sched *s);
+void acq_sync(acq_sched *s, const pulse_detector *pd, const pulse_params *p, uint32_t tracks);
+bool acq_burst_due(acq_sched *s, uint32_t t_ms);
+
+#endif // ACQ_H
@@ -1,4 +1,8 @@
 #include "main.h"
+#include "acq.h"
+
+// burst scheduler, synced from the main loop
+extern acq_sched adc_sched;
 
 void ADC_DMA_Config(void);
 
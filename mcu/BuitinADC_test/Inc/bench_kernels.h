@@ -0,0 +1,24 @@
+/*
+ * Kernel table shared by the benchmark harnesses.
+ *
+ * Only portable code lives here, each harness brings its own timer.
+ */
+
+#ifndef BENCH_KERNELS_H
+#define BENCH_KERNELS_H
+
+#include <stdint.h>
+
+typedef struct {
+  const char *name;
+  uint32_t samples;         // samples processed per call of run()
+  void (*prepare)(void);    // untimed, called before every run() (may be NULL)
+  float (*run)(void);       // timed, result is returned so it can't be optimised away
+} bench_kernel;
+
+extern const bench_kernel bench_kernels[];
+extern const uint32_t bench_kernel_count;
+
+void bench_init(void);
+
+#endif // BENCH_KERNELS_H
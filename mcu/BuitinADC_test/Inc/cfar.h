@@ -0,0 +1,78 @@
+/*
+ * Ordered statistic CFAR noise gate.
+ *
+ * Keeps a window of noise readings taken between beacon pulses and uses
+ * their rank-th smallest as the noise floor, so a few interfering pulses in
+ * the window do not lift it. The threshold is the floor times a factor set
+ * from the wanted false alarm probability.
+ *
+ * The factor is solved for readings that are each a sum of `looks`
+ * independent noise powers, each exponentially distributed: 1 for one
+ * channel's bin power, 2 for the X + Y power. Other statistics (a hypot of
+ * the two powers, say) do not meet the design rate. A tested value can be
+ * the mean of avg such readings, as a smoothed power is: its noise is then
+ * a sum of looks * avg powers over avg, and the factor is lower.
+ *
+ * Work per reading is O(window), the window is sorted by insertion.
+ */
+
+#ifndef CFAR_H
+#define CFAR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// longest reference window
+#define CFAR_WINDOW 32
+
+typedef struct
+{
+  uint32_t window;      // reference readings, up to CFAR_WINDOW
+  uint32_t rank;        // order statistic used as the floor, 1..window
+  float pfa;            // false alarm probability per test
+  uint32_t looks;       // noise powers summed per reading, 0 is taken as 1
+  uint32_t avg;         // readings averaged per tested value, 0 is taken as 1
+} cfar_params;
+
+typedef struct
+{
+  float alpha;          // threshold over the floor for pfa
+  uint32_t window;
+  uint32_t rank;
+  uint32_t n;           // readings held
+  uint32_t head;        // oldest reading once full
+  float ring[CFAR_WINDOW];
+  float sorted[CFAR_WINDOW];
+} cfar_detector;
+
+void cfar_init(cfar_detector *cf, const cfar_params *p);
+void cfar_push(cfar_detector *cf, float noise);
+float cfar_threshold(const cfar_detector *cf);
+float cfar_pfa(uint32_t window, uint32_t rank, uint32_t looks, uint32_t avg, float alpha);
+float cfar_alpha(uint32_t window, uint32_t rank, uint32_t looks, uint32_t avg, float pfa);
+
+/*
+ * True once the window is full and the threshold can be used.
+ */
+static inline bool cfar_ready(const cfar_detector *cf)
+{
+  return cf->n == cf->window;
+}
+
+/*
+ * Noise floor, the rank-th smallest reading.
+ */
+static inline float cfar_floor(const cfar_detector *cf)
+{
+  return cf->sorted[cf->rank - 1];
+}
+
+/*
+ * True if a reading is over the threshold, or the floor is not known yet.
+ */
+static inline bool cfar_detect(const cfar_detector *cf, float power)
+{
+  return !cfar_ready(cf) || power > cfar_threshold(cf);
+}
+
+#endif // CFAR_H
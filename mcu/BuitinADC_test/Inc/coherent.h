@@ -0,0 +1,56 @@
+/*
+ * Coherent integration of the bursts of one pulse.
+ *
+ * Each burst's bins have the carrier's phase at the burst start. With the
+ * start taken from the DWT cycle counter, which runs off the same PLL as the
+ * ADC clock, the phase the carrier turned through since the first burst is
+ * known and taken out. What is left turns by the residual frequency offset,
+ * which is found from the phase steps between bursts (unambiguous to half
+ * the burst rate, +-50 Hz at 10 ms) and taken out too. The bins are then
+ * summed before squaring, so over n bursts the signal power grows by n^2
+ * against the noise by n: an SNR gain of n, where averaging powers only
+ * gives sqrt(n).
+ *
+ * The gain achieved is reported from how well the bursts add up; it falls
+ * to 0 dB for noise or a carrier that drifts within the pulse.
+ *
+ * When undersampling, the phase at each burst start is still the RF
+ * carrier's, so the carrier given is the RF one, not the IF.
+ */
+
+#ifndef COHERENT_H
+#define COHERENT_H
+
+#include "dsp.h"
+#include <stdint.h>
+
+// bursts integrated per pulse, later ones are left out
+#define COH_MAX_BURSTS 16
+
+typedef struct
+{
+  float cpu_hz;           // DWT count rate
+  uint32_t step;          // carrier phase per count, full turn is 2^32
+  uint32_t t0;            // DWT count at the first burst
+  uint32_t n;
+  uint32_t t[COH_MAX_BURSTS];       // burst start, counts from t0
+  dsp_complex x[COH_MAX_BURSTS];    // bins with the carrier phase taken out
+  dsp_complex y[COH_MAX_BURSTS];
+} coh_integrator;
+
+typedef struct
+{
+  uint32_t n;             // bursts integrated
+  float px;               // coherent powers, in the units of one burst's power
+  float py;
+  float pxy;              // cross term, Re(X * conj(Y))
+  float offset_hz;        // residual carrier offset across the pulse
+  float coherence;        // |sum|^2 / (n sum |z|^2), 1 for a steady carrier
+  float gain_db;          // SNR gain over one burst, 10 log10(n coherence)
+} coh_result;
+
+void coh_start(coh_integrator *ci, float carrier_hz, float cpu_hz, uint32_t t);
+void coh_push(coh_integrator *ci, uint32_t t, dsp_complex x, dsp_complex y);
+coh_result coh_finish(const coh_integrator *ci);
+
+#endif // COHERENT_H
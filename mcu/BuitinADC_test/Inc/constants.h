@@ -1417,3 +1417,49 @@ int16_t flattop_int16_3600[3600] = {
 -14,-14,-14,-13,
 -13,-13,-13,-13,
 -13,-13,-13,-13};
+
+
+int16_t flattop_int16_144[144] = {
+-13,-15,-20,-28,
+-41,-57,-78,-104,
+-136,-175,-220,-274,
+-335,-405,-485,-574,
+-672,-779,-895,-1019,
+-1149,-1285,-1424,-1564,
+-1702,-1836,-1961,-2074,
+-2170,-2245,-2294,-2312,
+-2292,-2230,-2119,-1955,
+-1731,-1444,-1087,-656,
+-148,439,1111,1866,
+2707,3631,4639,5727,
+6890,8125,9425,10782,
+12188,13634,15108,16600,
+18098,19589,21059,22497,
+23888,25219,26477,27650,
+28726,29693,30542,31264,
+31851,32297,32597,32748,
+32748,32597,32297,31851,
+31264,30542,29693,28726,
+27650,26477,25219,23888,
+22497,21059,19589,18098,
+16600,15108,13634,12188,
+10782,9425,8125,6890,
+5727,4639,3631,2707,
+1866,1111,439,-148,
+-656,-1087,-1444,-1731,
+-1955,-2119,-2230,-2292,
+-2312,-2294,-2245,-2170,
+-2074,-1961,-1836,-1702,
+-1564,-1424,-1285,-1149,
+-1019,-895,-779,-672,
+-574,-485,-405,-335,
+-274,-220,-175,-136,
+-104,-78,-57,-41,
+-28,-20,-15,-13};
+
+// window for one burst of BUF_SIZE samples
+#ifdef ACQ_UNDERSAMPLE
+#define BURST_WINDOW flattop_int16_144
+#else
+#define BURST_WINDOW flattop_int16_3600
+#endif
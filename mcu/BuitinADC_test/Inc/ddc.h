@@ -0,0 +1,79 @@
+/*
+ * Digital downconverter, ADC samples to a narrowband complex stream.
+ *
+ * An NCO mixes the carrier to DC, a third order CIC decimates by 36 and a
+ * 32 tap compensating FIR by 4, so 3.6 MS/s in gives 25 kS/s of I/Q around
+ * the carrier. When undersampling (ACQ_UNDERSAMPLE) the CIC decimates by 3
+ * from 140.625 kS/s, 11.7 kS/s out. Unlike one Goertzel bin per burst, the
+ * stream shows the pulse edges, the frequency offset (phase step per output)
+ * and the phase between channels continuously.
+ *
+ * All integer: the CIC runs on wrapping 32 bit arithmetic and the FIR keeps
+ * a doubled delay line so each output is one straight dot product. On the
+ * target (ARM_MATH_CM7) the FIR is CMSIS-DSP's arm_fir_decimate_q15 instead,
+ * run over the CIC outputs staged in each call; it truncates where the
+ * portable FIR rounds, so outputs can differ by an LSB. A tone of amplitude
+ * A counts reads as |z| = DDC_GAIN * A once the filters have filled,
+ * DDC_DELAY outputs after it starts.
+ *
+ * The FIR taps and NCO table are generated by scripts/gen-ddc-fir.py.
+ */
+
+#ifndef DDC_H
+#define DDC_H
+
+#include <stdint.h>
+#ifdef ARM_MATH_CM7
+#include "arm_math.h"
+#endif
+#ifdef ACQ_UNDERSAMPLE
+#include "ddc_coeffs_undersample.h"
+#else
+#include "ddc_coeffs.h"
+#endif
+
+// DDC_CIC_R and DDC_CIC_SHIFT come with the coefficients
+#define DDC_CIC_ORDER 3
+#define DDC_FIR_R 4
+
+// input samples per output
+#define DDC_DECIM (DDC_CIC_R * DDC_FIR_R)
+
+// output magnitude per count of input amplitude
+#define DDC_GAIN 4.0f
+
+// outputs before a step at the input has settled
+#define DDC_DELAY ((DDC_FIR_TAPS + DDC_CIC_ORDER) / DDC_FIR_R + 1)
+
+// CIC outputs staged per arm_fir_decimate_q15 call, a multiple of DDC_FIR_R
+#define DDC_STAGE (8 * DDC_FIR_R)
+
+typedef struct {
+  int16_t i;
+  int16_t q;
+} ddc_iq;
+
+typedef struct {
+  uint32_t phase;       // NCO phase, full turn is 2^32
+  uint32_t step;        // phase step per input sample
+  uint32_t integ[2][DDC_CIC_ORDER];   // I and Q integrators
+  uint32_t comb[2][DDC_CIC_ORDER];    // last input of each comb stage
+  uint32_t cic_count;   // inputs since the last CIC output
+#ifdef ARM_MATH_CM7
+  arm_fir_decimate_instance_q15 fir[2];
+  q15_t fir_state[2][DDC_FIR_TAPS + DDC_STAGE - 1];
+  int16_t stage[2][DDC_STAGE];        // CIC outputs waiting for the FIR
+  uint32_t staged;
+#else
+  uint32_t fir_count;   // CIC outputs since the last FIR output
+  uint32_t head;        // next delay line slot
+  int16_t delay[2][2 * DDC_FIR_TAPS]; // CIC outputs, stored twice
+#endif
+} ddc_state;
+
+void ddc_init(ddc_state *d, float freq, float fs);
+void ddc_reset(ddc_state *d);
+uint32_t ddc_process(ddc_state *d, const int16_t *in, uint32_t n, int16_t dc, ddc_iq *out);
+float ddc_power(const ddc_iq *z, uint32_t n);
+
+#endif // DDC_H
@@ -1,4 +1,128 @@
-#include "main.h"
-#include "globals.h"
+#ifndef DSP_H
+#define DSP_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// maximum number of bins for the multi-bin kernel
+#define DSP_MAX_BINS 4
+
+// headroom shift for the fixed point fused kernels. The state bound for a
+// full scale burst, 2^(26-8) BUF_SIZE / sin(omega), is about 1.3e9 for 3600
+// samples at 457 kHz: past 2^30 but under 2^31. Undersampling's 144
+// samples stay near 2^25
+#define DSP_Q31_HEADROOM 8
+
+// raw 12 bit samples at or beyond these count as clipped
+#define DSP_CLIP_LO 2
+#define DSP_CLIP_HI 4093
+
+/*
+ * Precomputed Goertzel coefficients for one bin.
+ *
+ * Build once with goertzel_plan_init() and reuse for every block.
+ */
+typedef struct {
+  uint32_t n;         // block length in samples
+  int32_t k;          // bin index, nearest for a fractional plan
+  float coeff;        // 2*cos(omega)
+  float cosine;
+  float sine;
+  float scale;        // n / 2, normalises the bin magnitude
+  int32_t coeff_q29;  // coeff in Q29 for the fixed point kernels, 2 fits
+} goertzel_plan;
+
+/*
+ * Complex bin value. The phase is relative to the block start, so only phase
+ * differences between channels sampled together are meaningful.
+ */
+typedef struct {
+  float re;
+  float im;
+} dsp_complex;
+
+/*
+ * Raw sample statistics of one burst, gathered while windowing.
+ */
+typedef struct {
+  int16_t min;
+  int16_t max;
+  uint32_t clipped;   // samples at or beyond DSP_CLIP_LO / DSP_CLIP_HI
+  int32_t sum;        // raw samples added up, for the dc estimate
+} dsp_clip_stats;
+
+/*
+ * Operating point of one ADC channel, a slow IIR over the burst means. The
+ * mean comes from the windowing pass, the estimate is used for the next
+ * burst.
+ */
+typedef struct {
+  float dc;           // counts
+  float alpha;        // IIR gain per burst
+  bool init;          // first burst taken as is
+} dsp_dc_tracker;
+
+void goertzel_plan_init(goertzel_plan *plan, float target_freq, float sampling_rate, uint32_t n);
+void goertzel_plan_init_bin(goertzel_plan *plan, int32_t k, uint32_t n);
+void goertzel_plan_init_frac(goertzel_plan *plan, float k, uint32_t n);
+
+void dsp_dc_init(dsp_dc_tracker *t, float dc, float alpha);
+void dsp_dc_update(dsp_dc_tracker *t, const dsp_clip_stats *st, uint32_t n);
+
+void dsp_window_q15(int16_t *buf, const int16_t *window, uint32_t n, int16_t dc);
+void dsp_window_q15_stats(int16_t *buf, const int16_t *window, uint32_t n, int16_t dc, dsp_clip_stats *st);
+
+float goertzel_power_f32(const goertzel_plan *plan, const int16_t *data);
+float goertzel_power_q31(const goertzel_plan *plan, const int16_t *data);
+float goertzel_power_fused(const goertzel_plan *plan, const int16_t *data, const int16_t *window, int16_t dc);
+float goertzel_power_fused_q31(const goertzel_plan *plan, const int16_t *data, const int16_t *window, int16_t dc,
+                               uint32_t shift);
+dsp_complex goertzel_bin_fused_q31(const goertzel_plan *plan, const int16_t *data, const int16_t *window,
+                                   int16_t dc, uint32_t shift);
+void goertzel_power_multibin(const goertzel_plan *plans, uint32_t nbins, const int16_t *data, float *power);
+void goertzel_bin_multibin(const goertzel_plan *plans, uint32_t nbins, const int16_t *data, dsp_complex *bins);
+void goertzel_bin_multibin_raw(const goertzel_plan *plans, uint32_t nbins, const int16_t *data, int16_t dc,
+                               float gain, dsp_clip_stats *st, dsp_complex *bins);
+void goertzel_bin_multibin_fused_q31(const goertzel_plan *plans, uint32_t nbins, const int16_t *data,
+                                     const int16_t *window, int16_t dc, uint32_t shift, dsp_clip_stats *st,
+                                     dsp_complex *bins);
+void goertzel_bin_dual(const goertzel_plan *plan, const int16_t *x, const int16_t *y, dsp_complex *zx,
+                       dsp_complex *zy);
+void goertzel_power_dual(const goertzel_plan *plan, const int16_t *x, const int16_t *y, float *px, float *py);
+dsp_complex goertzel_bin_f32(const goertzel_plan *plan, const int16_t *data);
 
 float goertzel_power_457k(int16_t *data);
+dsp_complex goertzel_bin_457k(int16_t *data);
+
+static inline float dsp_power(dsp_complex z)
+{
+  return z.re*z.re + z.im*z.im;
+}
+
+/*
+ * Re(x * conj(y)), |x||y|cos of the phase between two channels. Its sign
+ * tells whether the channels are in phase or in antiphase.
+ */
+static inline float dsp_cross(dsp_complex x, dsp_complex y)
+{
+  return x.re*y.re + x.im*y.im;
+}
+
+/*
+ * True if the ADC clipped during the burst, its power reads low.
+ */
+static inline bool dsp_saturated(const dsp_clip_stats *st)
+{
+  return st->clipped > 0;
+}
+
+/*
+ * Operating point to subtract from the next burst.
+ */
+static inline int16_t dsp_dc_get(const dsp_dc_tracker *t)
+{
+  return (int16_t) lrintf(t->dc);
+}
+
+#endif // DSP_H
@@ -0,0 +1,94 @@
+/*
+ * Carrier frequency tracking.
+ *
+ * Every burst inside a pulse is measured at three frequencies: the tuned
+ * carrier and span bins either side of it. At the end of the pulse the
+ * summed powers give the offset of the tone from the centre by a parabola
+ * through their logs, which for a Gaussian like window lobe is close to
+ * exact. The offset is smoothed over pulses and the Goertzel plans are
+ * periodically rebuilt, fractional bin, on the measured frequency, so an off
+ * nominal beacon or a drifting ADC clock does not lose power to the window.
+ *
+ * With the flattop the three bins are spaced two apart, the lobe is too flat
+ * near its top for neighbours. The interpolation then reads 1.686 times the
+ * offset for small offsets and less for large ones; the estimate is scaled
+ * by the small offset slope and the retuning loop removes what is left, as
+ * it settles where the side bins are equal.
+ *
+ * When the nominal frequency sits on a bin centre and the tone is found
+ * within rect_max_bins of it, the bursts can be measured without the window
+ * (freq_rect()). The side bins are then on the rectangular window's nulls,
+ * the power leaking into them gives the offset, |z(m)| / |z(0)| = d / |d - m|
+ * for a tone d bins off, and a pulse further off than rect_max_bins falls
+ * back to the flattop at once. The tracker returns to the rectangular window
+ * at a retune once the flattop estimate is back within half of it.
+ *
+ * Storage is fixed, work per pulse is one log per bin and, on a retune, a
+ * sine and cosine per plan.
+ */
+
+#ifndef FREQ_H
+#define FREQ_H
+
+#include "dsp.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// bins measured per burst: below, centre, above
+#define FREQ_BINS 3
+#define FREQ_CENTRE 1
+
+// nominal frequency this close to a bin centre allows the rectangular window
+#define FREQ_RECT_CENTRED 0.05f
+
+typedef struct
+{
+  float span;             // bins from the centre to each side bin
+  float slope;            // interpolation output per bin of offset, set by the window
+  float alpha;            // weight of each pulse's estimate in the smoothed offset
+  float max_offset_hz;    // search range around the nominal frequency
+  uint32_t retune_pulses; // pulses between plan updates
+  float retune_hz;        // smallest change worth a retune
+  float rect_max_bins;    // offset up to which no window is needed, 0 to always window
+} freq_params;
+
+typedef struct
+{
+  float nominal_hz;
+  float fs;
+  uint32_t n;             // block length of the plans
+  float tuned_hz;         // frequency the plans are built for
+  float offset_hz;        // smoothed offset from nominal
+  uint32_t pulses;        // estimates since the last retune
+  uint32_t retunes;
+  float acc[FREQ_BINS];   // power over the pulse being collected
+  uint32_t bursts;
+  bool rect_ok;           // nominal is bin centred and rect_max_bins set
+  bool rect;              // bursts measured without the window
+  goertzel_plan plans[FREQ_BINS];
+} freq_tracker;
+
+void freq_init(freq_tracker *ft, const freq_params *p, float nominal_hz, float fs, uint32_t n);
+void freq_push(freq_tracker *ft, const float *power);
+bool freq_pulse_end(freq_tracker *ft, const freq_params *p);
+float freq_interp(float pm, float p0, float pp);
+float freq_rect_offset(float pm, float p0, float pp, float span);
+
+/*
+ * Current carrier estimate (Hz).
+ */
+static inline float freq_hz(const freq_tracker *ft)
+{
+  return ft->nominal_hz + ft->offset_hz;
+}
+
+/*
+ * True if the next bursts are to be measured without the window, on plans
+ * centred on the nominal bin.
+ */
+static inline bool freq_rect(const freq_tracker *ft)
+{
+  return ft->rect;
+}
+
+#endif // FREQ_H
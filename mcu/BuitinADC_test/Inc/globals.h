@@ -2,11 +2,30 @@
  * A common header file for global buffers and flags.
  */
 
-#include "main.h"
+#ifndef GLOBALS_H
+#define GLOBALS_H
+
 #include <stdint.h>
 
-// input buffer data size
+// ADC sample rate and where the 457 kHz carrier lands once sampled. The
+// undersampling mode runs the ADC at 140.625 kS/s and uses the front end's
+// narrow filter as the anti-alias filter, the carrier folds to 35.125 kHz
+// (close to fs/4). See scripts/alias-plan.py
+#define ACQ_CARRIER_HZ 457000.0f
+#ifdef ACQ_UNDERSAMPLE
+#define ACQ_FS_HZ 140625.0f
+#define ACQ_IF_HZ 35125.0f
+#else
+#define ACQ_FS_HZ 3600000.0f
+#define ACQ_IF_HZ ACQ_CARRIER_HZ
+#endif
+
+// input buffer data size, about 1 ms of samples in either mode
+#ifdef ACQ_UNDERSAMPLE
+#define BUF_SIZE 144
+#else
 #define BUF_SIZE 3600
+#endif
 
 // time between bursts (in ms)
 #define BURST_PERIOD_MS 10
@@ -20,3 +39,9 @@ extern volatile int16_t inbufy[BUF_SIZE];
 // input buffer flags
 extern volatile int inbufx_rdy; 
 extern volatile int inbufy_rdy;
+// HAL tick (ms) when the last burst started
+extern volatile uint32_t burst_tick;
+// DWT cycle count at the same point, for the carrier phase between bursts
+extern volatile uint32_t burst_cycles;
+
+#endif // GLOBALS_H
@@ -29,8 +29,17 @@ typedef struct
     int            turn_dir;   /* +1 or -1 */
     bool           seeded;
     Direction      last_dir;
+    float          hist_store[MAX_HIST_SIZE];   /* backing for history */
 } GuidanceState;
 
+/* extended guidance result */
+typedef struct 
+{
+    Direction dir;           /* legacy four way output */
+    float     heading_corr;  /* turn to make (rad), + left, - right, pi = U-turn */
+    float     confidence;    /* 0 (none) .. 1 */
+} GuidanceOutput;
+
 typedef struct 
 {
     uint32_t buf_size;       /* length of gbufx & gbufy */
@@ -38,11 +47,15 @@ typedef struct
     int      drop_steps;     /* consecutive drops → U-turn [10]*/
     int      reverse_cd;     /* cooldown ticks after U-turn [40]*/
     float    fwd_thresh;     /* straight-ahead angle cutoff (rad) [pi/8]*/
-    float    min_valid_mag;  /* ignore anything weaker than this 1000*/
+    float    min_valid_mag;  /* ignore anything weaker (tracker swaps in the CFAR threshold) */
 } GuidanceParams;
 
 bool guidance_state_init(GuidanceState *st, const GuidanceParams *p);
 
 Direction guidance_step(const float *gbufx, const float *gbufy, uint32_t posx, uint32_t posy, GuidanceState *st, const GuidanceParams *p);
 
+Direction guidance_step_signed(const float *gbufx, const float *gbufy, uint32_t posx, uint32_t posy, float xy_cross, GuidanceState *st, const GuidanceParams *p);
+
+GuidanceOutput guidance_step_ext(const float *gbufx, const float *gbufy, uint32_t posx, uint32_t posy, const float *xy_cross, GuidanceState *st, const GuidanceParams *p);
+
 #endif /* GUIDANCE_H */
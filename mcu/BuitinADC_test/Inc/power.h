@@ -0,0 +1,76 @@
+/*
+ * Power buffering between the Goertzel output and guidance.
+ *
+ * Each channel's burst powers go through two smoothing stages: one at burst
+ * rate and one at guidance rate (every decim bursts). Each stage can be an
+ * exponential average, a boxcar or a CIC style integrate-and-dump, and the
+ * configuration can be changed at run time.
+ *
+ * The boxcar keeps a running sum over a ring of its inputs, O(1) per input.
+ * EMA and integrate-and-dump stages leave the ring unused.
+ */
+
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// default bursts per guidance update
+#define POWER_BUF_SIZE 5
+
+// averages kept for guidance and display
+#define POWER_AVG_BUF_SIZE 20
+
+// longest boxcar a stage can hold, EMA and CIC need no history
+#define SMOOTH_MAX_BOXCAR 16
+
+typedef enum
+{
+  SMOOTH_NONE,    // pass through
+  SMOOTH_EMA,     // exponential average, time constant tau
+  SMOOTH_BOXCAR,  // mean of the last len inputs
+  SMOOTH_CIC      // integrate len inputs then dump the mean, holds in between
+} smooth_mode;
+
+typedef struct
+{
+  smooth_mode mode;
+  float tau;      // EMA time constant, in input samples of the stage
+  uint32_t len;   // boxcar / integrate-and-dump length, in input samples
+} smooth_stage_cfg;
+
+typedef struct
+{
+  smooth_stage_cfg burst;   // stage at burst rate
+  smooth_stage_cfg guide;   // stage at guidance rate
+  uint32_t decim;           // bursts per guidance output
+} smooth_cfg;
+
+typedef struct
+{
+  smooth_stage_cfg cfg;
+  float alpha;              // EMA gain from tau
+  float acc;                // CIC integrator
+  uint32_t n;               // inputs seen (EMA) or integrated (CIC)
+  float out;
+  float box[SMOOTH_MAX_BOXCAR];   // boxcar inputs, oldest at head once full
+  uint32_t head;
+  float sum;                // boxcar running sum
+} smooth_stage;
+
+typedef struct
+{
+  uint32_t decim;
+  uint32_t phase;           // bursts since the last guidance output
+  smooth_stage burst;
+  smooth_stage guide;
+  float burst_out;          // latest burst rate output
+  float guide_out;          // latest guidance rate output
+} power_smoother;
+
+bool power_smoother_init(power_smoother *ps, const smooth_cfg *cfg);
+bool power_smoother_push(power_smoother *ps, float power);
+uint32_t power_smoother_span(const smooth_cfg *cfg);
+
+#endif // POWER_H
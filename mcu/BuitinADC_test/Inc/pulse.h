@@ -0,0 +1,65 @@
+/*
+ * Beacon pulse detector.
+ *
+ * Works on one power value per burst. Pulse edges are found against a noise
+ * floor with hysteresis, and the transmit period is learned from the rising
+ * edges. Once the period is stable the detector can predict when the beacon
+ * is off, so the DSP for those bursts can be skipped.
+ *
+ * Times are in ms and may wrap.
+ */
+
+#ifndef PULSE_H
+#define PULSE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct
+{
+  float on_ratio;           // rising edge when power > floor * on_ratio
+  float off_ratio;          // falling edge when power < floor * off_ratio
+  float floor_alpha;        // noise floor EMA gain (upwards, off-pulse only)
+  uint32_t min_period_ms;   // shortest accepted pulse period
+  uint32_t max_period_ms;   // longest accepted pulse period
+  float period_tol;         // relative error for an interval to match the period
+  uint32_t lock_count;      // matching intervals before the period is trusted
+  uint32_t guard_ms;        // margin kept around the predicted pulse
+  uint32_t miss_count;      // missed pulses before the period is dropped
+} pulse_params;
+
+typedef enum
+{
+  PULSE_OFF,    // between pulses
+  PULSE_RISE,   // first burst of a pulse
+  PULSE_ON,     // inside a pulse
+  PULSE_FALL    // first burst after a pulse
+} pulse_event;
+
+typedef struct
+{
+  bool on;
+  bool floor_valid;
+  bool have_rise;
+  bool locked;          // period is stable, pulse_expect() gates
+  float floor;          // noise floor power
+  float period;         // learned pulse period (ms), 0 if unknown
+  float on_time;        // learned pulse length (ms), 0 if unknown
+  uint32_t matches;     // consecutive intervals matching the period
+  uint32_t last_rise;   // time of the last rising edge
+} pulse_detector;
+
+void pulse_init(pulse_detector *pd);
+pulse_event pulse_update(pulse_detector *pd, const pulse_params *p, uint32_t t_ms, float power);
+bool pulse_expect(pulse_detector *pd, const pulse_params *p, uint32_t t_ms);
+uint32_t pulse_period_match(float period, uint32_t interval, float tol);
+
+/*
+ * True for bursts that hold beacon signal.
+ */
+static inline bool pulse_is_on(pulse_event ev)
+{
+  return ev == PULSE_RISE || ev == PULSE_ON;
+}
+
+#endif // PULSE_H
@@ -0,0 +1,21 @@
+/*
+ * Calibrated power to distance.
+ *
+ * Each channel's power is divided by its fitted front end gain, the sum
+ * follows the near field fall off (power as 1/r^6) and is looked up in a
+ * table indexed straight from the float's exponent and top mantissa bits.
+ * No log or root on the device, one table read per call.
+ *
+ * The calibration is generated by scripts/fit-range-cal.py into range_cal.h.
+ */
+
+#ifndef RANGE_H
+#define RANGE_H
+
+#include <stdint.h>
+
+void range_normalise(float *px, float *py, float *pxy);
+float range_lookup(float pn);
+float range_from_power(float px, float py);
+
+#endif // RANGE_H
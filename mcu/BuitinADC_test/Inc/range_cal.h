@@ -0,0 +1,63 @@
+/*
+ * Power to distance calibration, generated by scripts/fit-range-cal.py.
+ * Nominal gains 109.5 / 109.5 dB, no recording.
+ *
+ * Normalised power is the sum over channels of power * RANGE_CAL_SCALE.
+ * The table holds the distance in cm per key, the float bits shifted down
+ * by RANGE_CAL_SHIFT, counted from RANGE_CAL_KEY0.
+ */
+
+#ifndef RANGE_CAL_H
+#define RANGE_CAL_H
+
+#include <stdint.h>
+
+#define RANGE_CAL_GAIN_DB_X 109.50f
+#define RANGE_CAL_GAIN_DB_Y 109.50f
+#define RANGE_CAL_SCALE_X 1.122018e-11f
+#define RANGE_CAL_SCALE_Y 1.122018e-11f
+#define RANGE_CAL_EXPONENT 6.000f
+#define RANGE_CAL_SHIFT 20
+#define RANGE_CAL_KEY0 696u
+#define RANGE_CAL_LEN 432u
+
+static const uint16_t range_cal_cm[RANGE_CAL_LEN] = {
+10060,9875,9711,9565,9432,9312,9202,9100,8963,8797,8652,8521,
+8403,8296,8198,8107,7985,7838,7708,7591,7486,7391,7303,7222,
+7114,6983,6867,6763,6670,6585,6507,6435,6337,6221,6118,6025,
+5942,5866,5797,5732,5646,5542,5450,5368,5294,5226,5164,5107,
+5030,4937,4856,4782,4716,4656,4601,4550,4481,4399,4326,4261,
+4202,4148,4099,4053,3992,3919,3854,3796,3743,3695,3652,3611,
+3557,3491,3433,3382,3335,3292,3253,3217,3169,3110,3059,3013,
+2971,2933,2898,2866,2823,2771,2725,2684,2647,2613,2582,2554,
+2515,2469,2428,2391,2358,2328,2300,2275,2241,2199,2163,2130,
+2101,2074,2049,2027,1996,1959,1927,1898,1872,1848,1826,1806,
+1778,1746,1717,1691,1667,1646,1627,1609,1584,1555,1529,1506,
+1486,1467,1449,1433,1412,1386,1363,1342,1323,1307,1291,1277,
+1258,1234,1214,1196,1179,1164,1150,1137,1120,1100,1081,1065,
+1050,1037,1025,1013,998,980,963,949,936,924,913,903,
+889,873,858,845,834,823,813,804,792,778,765,753,
+743,733,725,717,706,693,681,671,662,653,646,638,
+629,617,607,598,590,582,575,569,560,550,541,533,
+525,519,512,507,499,490,482,474,468,462,456,451,
+445,436,429,423,417,412,407,402,396,389,382,377,
+371,367,362,358,353,346,341,335,331,327,323,319,
+314,309,303,299,295,291,288,284,280,275,270,266,
+263,259,256,253,250,245,241,237,234,231,228,226,
+222,218,215,211,208,206,203,201,198,194,191,188,
+186,183,181,179,176,173,170,168,165,163,161,160,
+157,154,152,149,147,145,144,142,140,137,135,133,
+131,130,128,127,125,122,120,119,117,115,114,113,
+111,109,107,106,104,103,102,101,99,97,96,94,
+93,92,91,90,88,87,85,84,83,82,81,80,
+79,77,76,75,74,73,72,71,70,69,68,67,
+66,65,64,63,62,61,60,59,58,58,57,56,
+56,55,54,53,52,51,51,50,50,49,48,47,
+46,46,45,45,44,43,43,42,41,41,40,40,
+39,39,38,37,37,36,36,36,35,34,34,33,
+33,32,32,32,31,31,30,30,29,29,29,28,
+28,27,27,26,26,26,25,25,25,24,24,24,
+23,23,23,22,22,22,21,21,21,20,20,20
+};
+
+#endif // RANGE_CAL_H
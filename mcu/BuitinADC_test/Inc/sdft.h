@@ -0,0 +1,63 @@
+/*
+ * Sliding DFT, one bin over a continuous stream of samples.
+ *
+ * Where the Goertzel gives one value per burst, the sliding DFT keeps the
+ * bin of the last n samples up to date with every sample and hands it out
+ * every hop samples, so the power inside a burst can be followed at a
+ * resolution of hop samples. With n = BUF_SIZE / 10 and hop = n / 4 that is
+ * 25 us, enough to place a pulse edge that falls inside a burst.
+ *
+ * Each sample costs one complex multiply-add: the new sample goes in, the
+ * one n back comes out and the sum turns by one bin step. The pole of that
+ * recursion is on the unit circle, so rounding errors would never die out;
+ * it is pulled in to r (just under 1) and the sample leaving is weighted by
+ * r^n to match, which keeps the error bounded on an endless stream at the
+ * cost of a slightly tapered window (r^n, e.g. 0.4 % at n = 360).
+ *
+ * The bin is normalised like the Goertzel plans, a tone of amplitude A
+ * counts reads |z| = A.
+ */
+
+#ifndef SDFT_H
+#define SDFT_H
+
+#include "dsp.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// longest window
+#define SDFT_MAX_N 512
+
+// default pole radius
+#define SDFT_DAMPING 0.99999f
+
+typedef struct
+{
+  uint32_t n;           // window length in samples
+  uint32_t hop;         // samples between outputs
+  float rot_re;         // r exp(j omega), one sample step
+  float rot_im;
+  float out_re;         // r^n exp(j omega n), weight of the sample leaving
+  float out_im;
+  float scale;          // 2 / n
+  float s_re;           // bin of the last n samples
+  float s_im;
+  uint32_t head;        // delay line slot of the sample n back
+  uint32_t wait;        // samples to the next output
+  int16_t delay[SDFT_MAX_N];
+} sdft_state;
+
+void sdft_init(sdft_state *s, float freq, float fs, uint32_t n, uint32_t hop, float r);
+void sdft_reset(sdft_state *s);
+uint32_t sdft_process(sdft_state *s, const int16_t *in, uint32_t len, int16_t dc, dsp_complex *out);
+float sdft_edge(const float *power, uint32_t m, uint32_t n, uint32_t hop, bool rising);
+
+/*
+ * Outputs from a block of len samples after a reset.
+ */
+static inline uint32_t sdft_outputs(uint32_t len, uint32_t n, uint32_t hop)
+{
+  return len < n ? 0 : (len - n) / hop + 1;
+}
+
+#endif // SDFT_H
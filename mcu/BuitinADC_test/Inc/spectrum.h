@@ -0,0 +1,45 @@
+/*
+ * Spectrum survey, a diagnostic view of what the antennas pick up.
+ *
+ * One burst goes through a real FFT and the bins up to fs/2 are reduced to
+ * SPEC_BANDS bands, each holding its strongest bin, so a narrow interferer
+ * near the carrier shows as well as broadband noise. Levels are dB relative
+ * to a full scale sine (2048 counts) on the window's coherent gain.
+ *
+ * The FFT runs in place on the start of one acquisition buffer with the
+ * other as its output, no RAM of its own past the band levels. The window
+ * is the burst's flattop, sampled down to SPEC_N points.
+ *
+ * On the target this is CMSIS arm_rfft_q15, elsewhere (host tests and
+ * benchmarks) a Goertzel per bin with the same scaling.
+ */
+
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include "globals.h"
+#include <stdint.h>
+
+// FFT length, its complex output has to fit in the other buffer
+#if BUF_SIZE >= 2048
+#define SPEC_N 1024
+#else
+#define SPEC_N 64
+#endif
+
+// bands reported from 0 to fs/2
+#define SPEC_BANDS 32
+
+typedef struct
+{
+  float band_hz;            // width of each band
+  float peak_hz;            // centre of the strongest bin
+  float peak_db;
+  float db[SPEC_BANDS];     // strongest bin in each band, dB full scale
+} spec_result;
+
+void spec_init(void);
+void spec_run(int16_t *buf, int16_t *work, const int16_t *window, uint32_t window_len, int16_t dc, float fs,
+              spec_result *r);
+
+#endif // SPECTRUM_H
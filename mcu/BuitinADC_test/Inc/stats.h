@@ -0,0 +1,57 @@
+/*
+ * Streaming statistics over a sliding window.
+ *
+ * Samples live in a circular buffer. The sum is updated incrementally with
+ * Kahan compensation, max and min are tracked with monotonic deques, so every
+ * push and query is O(1) (amortised for the deques) whatever the window size.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include "circ_buf.h"
+#include <stdint.h>
+
+typedef struct {
+  circ_buf_float circ;  // window samples, circ.idx is the next slot written
+  uint32_t count;       // samples in the window, saturates at circ.size
+  float sum;            // running sum of the window
+  float comp;           // Kahan compensation for sum
+  uint32_t *maxq;       // slot indices, values decreasing from head
+  uint32_t maxq_head;
+  uint32_t maxq_len;
+  uint32_t *minq;       // slot indices, values increasing from head
+  uint32_t minq_head;
+  uint32_t minq_len;
+} stats_window;
+
+void stats_window_init(stats_window *w, float *buf, uint32_t *maxq, uint32_t *minq, uint32_t size);
+void stats_window_push(stats_window *w, float val);
+
+/*
+ * Mean of the samples currently in the window (0 if empty).
+ */
+static inline float stats_window_mean(const stats_window *w)
+{
+  return w->count ? w->sum / w->count : 0.0f;
+}
+
+static inline float stats_window_max(const stats_window *w)
+{
+  return w->maxq_len ? w->circ.buf[w->maxq[w->maxq_head]] : 0.0f;
+}
+
+static inline float stats_window_min(const stats_window *w)
+{
+  return w->minq_len ? w->circ.buf[w->minq[w->minq_head]] : 0.0f;
+}
+
+/*
+ * Most recent sample.
+ */
+static inline float stats_window_last(stats_window *w)
+{
+  return circ_buf_rd_float(&w->circ);
+}
+
+#endif // STATS_H
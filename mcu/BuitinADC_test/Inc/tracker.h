@@ -0,0 +1,113 @@
+/*
+ * Multiple beacon tracker.
+ *
+ * Bursts of one pulse (as found by the pulse detector) are collected, then
+ * the pulse is matched to a track by its timing against each track's learned
+ * period and by its amplitude. Unmatched pulses start a new track. Every
+ * track has its own smoothing, averages and guidance state, so interleaved
+ * transmitters are steered to independently. The X/Y cross term is smoothed
+ * alongside the powers and gives guidance the side of the field.
+ *
+ * Bursts between pulses feed a CFAR noise floor shared by all tracks. Its
+ * threshold, when configured, replaces the guidance min_valid_mag. It is
+ * solved for the statistic guidance compares, the smoothed power, so the
+ * factor is set for the mean of the bursts the smoother averages; pulses
+ * whose powers were summed coherently are one reading, gated on their own
+ * factor scaled down by the bursts summed.
+ *
+ * A pulse with a clipped burst marks its track saturated: the power reads
+ * low, so guidance confidence is halved until an unclipped pulse arrives.
+ *
+ * All storage is fixed, work per burst is O(1) and per pulse O(TRACK_MAX).
+ */
+
+#ifndef TRACKER_H
+#define TRACKER_H
+
+#include "cfar.h"
+#include "guidance.h"
+#include "power.h"
+#include "pulse.h"
+#include "stats.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// transmitters tracked at once
+#define TRACK_MAX 3
+
+// bursts kept per pulse, longer pulses are truncated
+#define TRACK_PULSE_BURSTS 16
+
+typedef struct
+{
+  uint32_t min_period_ms;         // shortest accepted pulse period
+  uint32_t max_period_ms;         // longest accepted pulse period
+  float period_tol;               // relative timing error for a match
+  float amp_tol_db;               // amplitude error for a match
+  uint32_t miss_count;            // missed pulses before a track is dropped
+  const smooth_cfg *smooth;       // smoothing for every track
+  const GuidanceParams *guidance; // guidance for every track
+  const cfar_params *cfar;        // noise gate, NULL keeps min_valid_mag
+} tracker_params;
+
+typedef struct
+{
+  bool active;
+  uint32_t id;                    // changes each time the slot is reused
+  uint32_t pulses;                // pulses assigned
+  uint32_t last_rise;             // tick of the last pulse
+  float period;                   // learned period (ms), 0 if unknown
+  float amp;                      // mean pulse power, X + Y
+  power_smoother smoothx;
+  power_smoother smoothy;
+  power_smoother smoothc;         // X/Y cross term, Re(X * conj(Y))
+  float cross;                    // smoothed cross term at guidance rate
+  bool saturated;                 // last pulse had a clipped burst
+  stats_window avgx;              // guidance rate averages
+  stats_window avgy;
+  float avgbufx[POWER_AVG_BUF_SIZE];
+  float avgbufy[POWER_AVG_BUF_SIZE];
+  uint32_t avgqx[2][POWER_AVG_BUF_SIZE];
+  uint32_t avgqy[2][POWER_AVG_BUF_SIZE];
+  GuidanceState guidance;
+  GuidanceOutput out;             // last guidance output
+} track;
+
+typedef struct
+{
+  track tracks[TRACK_MAX];
+  int32_t selected;               // track guided to, -1 for none
+  uint32_t next_id;
+  // pulse being collected
+  bool in_pulse;
+  uint32_t rise;
+  uint32_t nbursts;
+  uint32_t coh_n;                 // bursts summed coherently into the powers, 0 if not
+  bool sat;
+  float px[TRACK_PULSE_BURSTS];
+  float py[TRACK_PULSE_BURSTS];
+  float pc[TRACK_PULSE_BURSTS];
+  cfar_detector noise;            // floor from bursts between pulses
+  float coh_alpha;                // noise gate factor for one coherent reading
+} tracker;
+
+void tracker_init(tracker *tr, const tracker_params *p);
+int32_t tracker_push(tracker *tr, const tracker_params *p, uint32_t t_ms, pulse_event ev, float px, float py, float pxy,
+                     bool sat);
+void tracker_pulse_power(tracker *tr, float px, float py, float pxy, uint32_t n);
+void tracker_pulse_rise(tracker *tr, uint32_t rise_ms);
+uint32_t tracker_count(const tracker *tr);
+bool tracker_expect(const tracker *tr, pulse_detector *pd, const pulse_params *pp, uint32_t t_ms);
+bool tracker_select(tracker *tr, uint32_t id);
+void tracker_select_next(tracker *tr);
+
+/*
+ * Track being guided to, NULL if none.
+ */
+static inline track *tracker_selected(tracker *tr)
+{
+  return tr->selected >= 0 ? &tr->tracks[tr->selected] : NULL;
+}
+
+#endif // TRACKER_H
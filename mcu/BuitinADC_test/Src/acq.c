@@ -0,0 +1,63 @@
+#include "acq.h"
+
+void acq_init(acq_sched *s)
+{
+  s->state = ACQ_SCAN;
+  s->last_rise = 0;
+  s->period_ms = 0;
+  s->open_ms = 0;
+  s->close_ms = 0;
+  s->lost_ms = 0;
+  s->bursts = 0;
+  s->skipped = 0;
+}
+
+/*
+ * Copy the pulse timing from the detector. Call after each pulse_update()
+ * with the number of transmitters tracked, more than one keeps scanning as
+ * the detector's window only covers one of them.
+ */
+void acq_sync(acq_sched *s, const pulse_detector *pd, const pulse_params *p, uint32_t tracks)
+{
+  if (!pd->locked || tracks > 1) {
+    s->state = ACQ_SCAN;
+    return;
+  }
+
+  uint32_t on_time = pd->on_time > 0 ? (uint32_t) pd->on_time : p->guard_ms;
+
+  s->last_rise = pd->last_rise;
+  s->period_ms = (uint32_t) (pd->period + 0.5f);
+  s->open_ms = p->guard_ms;
+  s->close_ms = on_time + p->guard_ms;
+  s->lost_ms = p->miss_count * s->period_ms + p->guard_ms;
+  s->state = ACQ_LOCKED;
+}
+
+/*
+ * Called for every burst slot, returns true if the burst should run.
+ */
+bool acq_burst_due(acq_sched *s, uint32_t t_ms)
+{
+  bool due = true;
+
+  if (s->state == ACQ_LOCKED) {
+    uint32_t elapsed = t_ms - s->last_rise;
+    if (elapsed > s->lost_ms) {
+      // pulses stopped, scan until the detector locks again
+      s->state = ACQ_SCAN;
+    }
+    else {
+      uint32_t phase = elapsed % s->period_ms;
+      due = phase <= s->close_ms || phase >= s->period_ms - s->open_ms;
+    }
+  }
+
+  if (due) {
+    s->bursts++;
+  }
+  else {
+    s->skipped++;
+  }
+  return due;
+}
@@ -6,10 +6,25 @@
 #include "stm32f722xx.h"
 #include "stm32f7xx_hal_rcc_ex.h"
 
+// conversion rate is the ADC clock over sampling time + 12 cycles, both
+// ADCs run from PCLK2 (108 MHz)
+#ifdef ACQ_UNDERSAMPLE
+// 13.5 MHz / 96 cycles = 140.625 kS/s
+#define ADC_CLOCK LL_ADC_CLOCK_SYNC_PCLK_DIV8
+#define ADC_SAMPLING_TIME LL_ADC_SAMPLINGTIME_84CYCLES
+#else
+// 54 MHz / 15 cycles = 3.6 MS/s
+#define ADC_CLOCK LL_ADC_CLOCK_SYNC_PCLK_DIV2
+#define ADC_SAMPLING_TIME LL_ADC_SAMPLINGTIME_3CYCLES
+#endif
+
 volatile int16_t inbufx[BUF_SIZE]; 
 volatile int16_t inbufy[BUF_SIZE]; 
 volatile int inbufx_rdy = 0; 
 volatile int inbufy_rdy = 0;
+volatile uint32_t burst_tick = 0;
+volatile uint32_t burst_cycles = 0;
+acq_sched adc_sched;
 
 
 static void ADCx_DMAx_StreamConfig(ADC_TypeDef *ADCx, 
@@ -24,6 +39,8 @@ static void ADCx_DMAx_StreamConfig(ADC_TypeDef *ADCx,
 
 void ADC_DMA_Config(void) 
 {
+  acq_init(&adc_sched);
+
   __HAL_RCC_ADC1_CLK_ENABLE();
   __HAL_RCC_ADC2_CLK_ENABLE();
   __HAL_RCC_DMA2_CLK_ENABLE();
@@ -32,7 +49,7 @@ void ADC_DMA_Config(void)
 
   LL_ADC_CommonInitTypeDef adc_commoninit;
   adc_commoninit.Multimode = LL_ADC_MULTI_INDEPENDENT; 
-  adc_commoninit.CommonClock = LL_ADC_CLOCK_SYNC_PCLK_DIV2; 
+  adc_commoninit.CommonClock = ADC_CLOCK; 
   adc_commoninit.MultiDMATransfer = LL_ADC_MULTI_REG_DMA_EACH_ADC;
   // configure common features of ADCs
   if (LL_ADC_CommonInit(ADC, &adc_commoninit)) {
@@ -135,7 +152,7 @@ static void ADCx_DMAx_StreamConfig(ADC_TypeDef *ADCx,
     // error
   }
   LL_ADC_REG_SetSequencerRanks(ADCx, LL_ADC_REG_RANK_1, ADC_Channel);        // configure sequencer rank
-  LL_ADC_SetChannelSamplingTime(ADCx, ADC_Channel, LL_ADC_SAMPLINGTIME_3CYCLES);  // configure sampling time
+  LL_ADC_SetChannelSamplingTime(ADCx, ADC_Channel, ADC_SAMPLING_TIME);  // configure sampling time
   LL_ADC_Enable(ADCx);            // enable ADC
 }
 
@@ -146,8 +163,9 @@ void ADC_SysTick_Handler(void)
   // init ADC burst every period
   if (count_ms == BURST_PERIOD_MS) {
     count_ms = 0;
-    // make sure configuration is complete
-    if (config_cplt) {
+    // make sure configuration is complete, and skip slots outside the
+    // predicted pulse when locked
+    if (config_cplt && acq_burst_due(&adc_sched, HAL_GetTick())) {
       // it is necessary to invalidate cache here so that changes in cache are not written 
       // through at a later time
       SCB_InvalidateDCache_by_Addr((uint32_t*)(((uint32_t)inbufx) & ~(uint32_t)0x1F), BUF_SIZE*2+32);
@@ -177,6 +195,8 @@ void ADC_SysTick_Handler(void)
       ADC1->CR2 |= (1 << 8); 
       ADC2->CR2 |= (1 << 8);
       // start ADC conversion
+      burst_tick = HAL_GetTick();
+      burst_cycles = DWT->CYCCNT;
       LL_ADC_REG_StartConversionSWStart(ADC1);    
       LL_ADC_REG_StartConversionSWStart(ADC2);   
     }
@@ -11,48 +11,56 @@
 #include "constants.h"
 #include "UART.h"
 #include <stdio.h>
+#include <math.h>
 #include "guidance.h"
 #include "circ_buf.h"
-
-/*********************** 
- * Defines 
- * ********************/
-
-#define POWER_AVG_BUF_SIZE 20
-#define POWER_BUF_SIZE 5
+#include "power.h"
+#include "pulse.h"
+#include "tracker.h"
+#include "pf.h"
+#include "range.h"
+#include "freq.h"
+#include "coherent.h"
+#include "sdft.h"
+#include "spectrum.h"
 
 /********************* 
  * Globals 
  * ******************/
 
-// power buffers
-float powerbufx[POWER_BUF_SIZE];
-float powerbufy[POWER_BUF_SIZE];
-circ_buf_float powerbufcircx; 
-circ_buf_float powerbufcircy;
+// power smoothing per track, default is a boxcar over the bursts of one
+// guidance update
+smooth_cfg g_smooth_cfg =
+{
+  .burst = {.mode = SMOOTH_BOXCAR, .tau = 0,   .len = POWER_BUF_SIZE},
+  .guide = {.mode = SMOOTH_NONE,   .tau = 0,   .len = 1},
+  .decim = POWER_BUF_SIZE
+};
 
-// avg power buffers
-float avgpowerbufx[POWER_AVG_BUF_SIZE];
-float avgpowerbufy[POWER_AVG_BUF_SIZE];
-circ_buf_float avgpowerbufcircx;
-circ_buf_float avgpowerbufcircy;
+// beacon pulse detector, bursts outside the pulses are dropped
+pulse_detector g_pulse;
+pulse_params g_pulse_params =
+{
+  .on_ratio      = 4.0f,    // 6 dB over the floor starts a pulse
+  .off_ratio     = 2.0f,    // 3 dB over the floor ends it
+  .floor_alpha   = 0.05f,
+  .min_period_ms = 100,
+  .max_period_ms = 2000,
+  .period_tol    = 0.15f,
+  .lock_count    = 2,
+  .guard_ms      = 2 * BURST_PERIOD_MS,
+  .miss_count    = 3
+};
 
 // flag to tell if configuration complete
 volatile int config_cplt;
 
-// count of ADC bursts
-int burst_count;
-
-// count of avg power for calls to guicance 
-int guidance_count;
-
 int print_count;
 
 // buffer for usart transmit
 char uart_buf[1000];
 
-// Guidance state and parameters
-static GuidanceState  g_guidance_state;
+// Guidance parameters, each track has its own state
 static GuidanceParams g_guidance_params = 
 {
   .buf_size      = POWER_AVG_BUF_SIZE,   // consume the same buffer size you’re averaging over
@@ -60,7 +68,97 @@ static GuidanceParams g_guidance_params =
   .drop_steps    = 10,                   // how many drops before a U-turn
   .reverse_cd    = 40,                   // cooldown ticks after a U-turn
   .fwd_thresh    = 3.14159265/8.0f,      // straight‐ahead if angle ≤ 22.5°
-  .min_valid_mag =  4.0f                 // ignore magnitudes < 4
+  .min_valid_mag =  4.0f                 // until the noise floor is known, see g_cfar_params
+};
+
+// noise gate for guidance, floor from the bursts between pulses
+cfar_params g_cfar_params =
+{
+  .window = 32,       // a few seconds of off-pulse bursts once locked
+  .rank   = 24,       // 3/4 order statistic, robust to other beacons' pulses
+  .pfa    = 1e-3f,
+  .looks  = 2         // readings are X + Y power, the tracker sets avg from g_smooth_cfg
+};
+
+// ADC operating points, the front end bias drifts with temperature and supply
+#define DC_ALPHA (1.0f / 64)
+dsp_dc_tracker g_dcx;
+dsp_dc_tracker g_dcy;
+
+// carrier tracking, the Goertzel bins follow the beacon's actual frequency
+freq_tracker g_freq;
+freq_params g_freq_params =
+{
+  .span          = 2.0f,      // side bins two out, the flattop top is too flat for one
+  .slope         = 1.686f,    // flattop small offset slope at span 2
+  .alpha         = 0.25f,
+  .max_offset_hz = 3000.0f,   // inside the front end filter
+  .retune_pulses = 4,
+  .retune_hz     = 20.0f,
+  .rect_max_bins = 0.1f       // at most 0.14 dB lost without the window
+};
+
+// bins without the window are scaled by the flattop's coherent gain, so
+// powers read the same either way
+static float g_rect_gain;
+
+// coherent integration of each pulse's bursts, off to average burst powers
+static bool g_coherent = true;
+coh_integrator g_coh;
+coh_result g_coh_res;
+
+// beacon tracks, pulses are split between transmitters by timing and amplitude
+tracker g_tracker;
+tracker_params g_tracker_params =
+{
+  .min_period_ms = 100,
+  .max_period_ms = 2000,
+  .period_tol    = 0.15f,
+  .amp_tol_db    = 6.0f,
+  .miss_count    = 3,
+  .smooth        = &g_smooth_cfg,
+  .guidance      = &g_guidance_params,
+  .cfar          = &g_cfar_params
+};
+
+// pulse edges placed inside a burst by a sliding DFT, 0.1 ms window handed
+// out every 25 us. The rise times the tracker's pulses off the burst grid
+// and the two edges give the reported width. They cost about as much as the
+// burst's bins again, clear this to trade the timing back for the cycles
+static bool g_edges = true;
+#define EDGE_LEN (BUF_SIZE / 10)
+#define EDGE_HOP (EDGE_LEN / 4)
+#define EDGE_OUTS ((BUF_SIZE - EDGE_LEN) / EDGE_HOP + 1)
+sdft_state g_sdftx;
+sdft_state g_sdfty;
+float g_edge_power[2][EDGE_OUTS];   // X + Y, this burst and the one before
+uint32_t g_edge_cycles[2];          // DWT count at each burst start
+bool g_edge_valid[2];
+uint32_t g_edge_cur;
+bool g_rise_known;
+uint32_t g_rise_cycles;
+uint32_t g_rise_ms;                 // the same rise on the SysTick clock
+int32_t g_width_us = -1;            // last pulse width, -1 if an edge was missed
+
+// spectrum survey of one burst between pulses, printed on its own UART line.
+// It is a diagnostic, the user button arms one and it disarms once run
+volatile bool g_spec_armed;
+spec_result g_spec;
+
+// beacon position estimate for the selected track
+pf_filter g_pf;
+uint32_t g_pf_track;
+pf_params g_pf_params =
+{
+  .moment      = 1.0f,      // powers are normalised by the range calibration
+  .depth_m     = 1.0f,
+  .range_min_m = 0.5f,
+  .range_max_m = 60.0f,
+  .step_m      = 1.0f,      // walking pace times the guidance interval
+  .pos_sigma_m = 0.3f,
+  .turn_sigma  = 0.05f,
+  .mag_sigma   = 0.2f,
+  .ang_sigma   = 0.2f
 };
 
 /*************************
@@ -68,8 +166,9 @@ static GuidanceParams g_guidance_params =
  * **********************/
 
 void process_step(void);
-void power_calc(int16_t *buf, circ_buf_float *pbuf);
-void avg_power(float *pbuf, circ_buf_float *avg_pbuf);
+dsp_complex bin_calc(int16_t *buf, dsp_dc_tracker *dc, sdft_state *sd, dsp_clip_stats *st, float *power);
+void edge_update(pulse_event ev, uint32_t tick, uint32_t cycles);
+void spectrum_survey(void);
 void app_init(void);
 
 /*************************** 
@@ -104,6 +203,12 @@ void app_main(void)
     {
       process_step();
     }
+    else
+    {
+      // sleep until SysTick or a DMA interrupt, a flag set just before this
+      // costs at most one tick
+      __WFI();
+    }
 
     LED_Toggle(LED2_PIN);
   }
@@ -115,51 +220,102 @@ void app_main(void)
 void app_init(void) 
 {
   // initialize counts
-  burst_count = 0;
-  guidance_count = 0;
   print_count = 0;
 
-  // init power circ bufs
-  circ_buf_init_float(&powerbufcircx, powerbufx, POWER_BUF_SIZE);
-  circ_buf_init_float(&powerbufcircy, powerbufy, POWER_BUF_SIZE);
+  pulse_init(&g_pulse);
+  tracker_init(&g_tracker, &g_tracker_params);
+  freq_init(&g_freq, &g_freq_params, ACQ_IF_HZ, ACQ_FS_HZ, BUF_SIZE);
+  dsp_dc_init(&g_dcx, 2048, DC_ALPHA);
+  dsp_dc_init(&g_dcy, 2048, DC_ALPHA);
 
-  // init avg power circ bufs
-  circ_buf_init_float(&avgpowerbufcircx, avgpowerbufx, POWER_AVG_BUF_SIZE);
-  circ_buf_init_float(&avgpowerbufcircy, avgpowerbufy, POWER_AVG_BUF_SIZE);
+  // the window's coherent gain, on the >> 12 scale of the windowed bins
+  g_rect_gain = 0;
+  for (uint32_t i = 0; i < BUF_SIZE; i++) {
+    g_rect_gain += BURST_WINDOW[i];
+  }
+  g_rect_gain /= 4096.0f * BUF_SIZE;
+
+  sdft_init(&g_sdftx, ACQ_IF_HZ, ACQ_FS_HZ, EDGE_LEN, EDGE_HOP, SDFT_DAMPING);
+  sdft_init(&g_sdfty, ACQ_IF_HZ, ACQ_FS_HZ, EDGE_LEN, EDGE_HOP, SDFT_DAMPING);
+  spec_init();
+  g_spec_armed = false;
+  pf_init(&g_pf, 1);
+  g_pf_track = 0;
+
+  // user button arms a spectrum survey, below the ADC DMA
+  HAL_NVIC_SetPriority(EXTI15_10_IRQn, 3, 0);
+  HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+}
 
-  guidance_state_init(&g_guidance_state, &g_guidance_params);
+/*
+ * User button press, arms one spectrum survey.
+ */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+  if (GPIO_Pin == USER_Btn_Pin) {
+    g_spec_armed = true;
+  }
 }
 
 void process_step(void) 
 {
+  dsp_complex binx = {0, 0};
+  dsp_complex biny = {0, 0};
+  dsp_clip_stats statx = {0, 0, 0, 0};
+  dsp_clip_stats staty = {0, 0, 0, 0};
+  float freq_power[FREQ_BINS] = {0, 0, 0};
+  uint32_t tick = burst_tick;
+  uint32_t cycles = burst_cycles;
+
+  // the survey takes a whole burst, only run between pulses
+  if (g_spec_armed && !g_pulse.on) {
+    g_spec_armed = false;
+    spectrum_survey();
+    g_edge_valid[g_edge_cur ^ 1] = false;
+    return;
+  }
+
+  // beacon is off, drop the burst without doing any DSP
+  if (!tracker_expect(&g_tracker, &g_pulse, &g_pulse_params, tick)) {
+    inbufx_rdy = 0;
+    inbufy_rdy = 0;
+    g_edge_valid[g_edge_cur ^ 1] = false;
+    return;
+  }
+
+  // edge powers of this burst are summed over both channels
+  for (uint32_t j = 0; j < EDGE_OUTS; j++) {
+    g_edge_power[g_edge_cur][j] = 0;
+  }
+
   // process both buffers
   switch((inbufy_rdy << 1) | inbufx_rdy) {
     // x ready only
     case 0x1:
       inbufx_rdy = 0;
-      power_calc((int16_t*) inbufx, &powerbufcircx);
+      binx = bin_calc((int16_t*) inbufx, &g_dcx, &g_sdftx, &statx, freq_power);
 
       // wait for y buffer
       while(!inbufy_rdy);
       inbufy_rdy = 0;
-      power_calc((int16_t*) inbufy, &powerbufcircy);
+      biny = bin_calc((int16_t*) inbufy, &g_dcy, &g_sdfty, &staty, freq_power);
     break;
     // y ready only
     case 0x2: 
       inbufy_rdy = 0;
-      power_calc((int16_t*) inbufy, &powerbufcircy);
+      biny = bin_calc((int16_t*) inbufy, &g_dcy, &g_sdfty, &staty, freq_power);
 
       // wait for x buffer
       while(!inbufx_rdy);
       inbufx_rdy = 0;
-      power_calc((int16_t*) inbufx, &powerbufcircx);
+      binx = bin_calc((int16_t*) inbufx, &g_dcx, &g_sdftx, &statx, freq_power);
     break;
     // both ready
     case 0x3: 
       inbufx_rdy = 0; 
       inbufy_rdy = 0;
-      power_calc((int16_t*) inbufx, &powerbufcircx);
-      power_calc((int16_t*) inbufy, &powerbufcircy);
+      binx = bin_calc((int16_t*) inbufx, &g_dcx, &g_sdftx, &statx, freq_power);
+      biny = bin_calc((int16_t*) inbufy, &g_dcy, &g_sdfty, &staty, freq_power);
     break;
     default: 
       // should never happen
@@ -167,112 +323,248 @@ void process_step(void)
 
   }
 
-  // increment burst count, calc the average power if power buf is full
-  burst_count++; 
-  if (burst_count == POWER_BUF_SIZE) {
-    burst_count = 0;
-
-    avg_power(powerbufx, &avgpowerbufcircx); 
-    avg_power(powerbufy, &avgpowerbufcircy);
-
-    float avgpower_x = 10 * log10f(circ_buf_rd_float(&avgpowerbufcircx));
-    float avgpower_y = 10 * log10f(circ_buf_rd_float(&avgpowerbufcircy));
-
-    guidance_count++;
-
-    if (guidance_count == 1) {
-      guidance_count = 0;
-      //Implement Guidance function call here.
-      Direction dir = guidance_step(avgpowerbufcircx.buf, avgpowerbufcircy.buf, avgpowerbufcircx.idx, avgpowerbufcircy.idx, &g_guidance_state, &g_guidance_params);
-      const char *dir_str = "????????";
-      switch(dir) 
-      {
-        case STRAIGHT_AHEAD: dir_str = "FWD";     
-          break;
-        case TURN_LEFT:      dir_str = "LEFT";    
-          break;
-        case TURN_RIGHT:     dir_str = "RIGHT";   
-          break;
-        case TURN_AROUND:    dir_str = "UTURN";   
-          break;
-        case NO_SIGNAL:      dir_str = "NOSIGNAL";
-          break;
-      }
+  // channel powers, clamped to 1 (to avoid negative power dB readings), and
+  // the cross term that gives the side of the field
+  float powerx = fmaxf(dsp_power(binx), 1.0f);
+  float powery = fmaxf(dsp_power(biny), 1.0f);
+  float cross = dsp_cross(binx, biny);
 
-      // snprintf(uart_buf, 1000, "parallel dB: %2d, perpindicular dB: %2d  dir: %8s\n\r", (int) avgpower_y, (int) avgpower_x, dir_str);
-      // snprintf(uart_buf, 1000, "parallel dB: %2d, perpindicular dB: %2d    %8s\n\r", (int) avgpower_y, (int) avgpower_x, msg);
-      // UART_Transmit(uart_buf);
+  // a clipped burst gives a bin that reads low and off angle
+  bool sat = dsp_saturated(&statx) || dsp_saturated(&staty);
 
-    }
+  // only bursts inside a pulse go on to averaging and guidance
+  pulse_event ev = pulse_update(&g_pulse, &g_pulse_params, tick, powerx + powery);
 
-    print_count++;
-    if (print_count == 10) {
-      print_count = 0;
+  // the bins of a pulse are summed with the carrier phase between bursts
+  // taken out, the carrier is the RF one at the frequency tracked (the IF
+  // zone is not inverted)
+  if (ev == PULSE_RISE) {
+    coh_start(&g_coh, ACQ_CARRIER_HZ + g_freq.tuned_hz - ACQ_IF_HZ, SystemCoreClock, cycles);
+  }
+  if (pulse_is_on(ev)) {
+    coh_push(&g_coh, cycles, binx, biny);
+  }
+  else if (ev == PULSE_FALL && g_coherent) {
+    g_coh_res = coh_finish(&g_coh);
+    tracker_pulse_power(&g_tracker, fmaxf(g_coh_res.px, 1.0f), fmaxf(g_coh_res.py, 1.0f), g_coh_res.pxy,
+                        g_coh_res.n);
+  }
 
-      float max_x = 0;
-      float max_y = 0;
+  if (g_edges) {
+    edge_update(ev, tick, cycles);
+  }
 
-      for (int i = 0; i < POWER_AVG_BUF_SIZE; i++) {
-        if (avgpowerbufx[i] > max_x) {
-          max_x = avgpowerbufx[i];
-        }
-        if (avgpowerbufy[i] > max_y) {
-          max_y = avgpowerbufy[i];
-        }
-      }
+  // carrier estimate from every pulse, the plans are retuned between pulses
+  if (pulse_is_on(ev)) {
+    freq_push(&g_freq, freq_power);
+  }
+  else if (ev == PULSE_FALL) {
+    freq_pulse_end(&g_freq, &g_freq_params);
+  }
 
-      float x_db = 10 * log10f(max_x);
-      float y_db = 10 * log10f(max_y);
+  // hand the pulse timing to the burst scheduler in the SysTick handler
+  __disable_irq();
+  acq_sync(&adc_sched, &g_pulse, &g_pulse_params, tracker_count(&g_tracker));
+  __enable_irq();
 
-      snprintf(uart_buf, 1000, "parallel dB: %2d; perpindicular dB: %2d \r\n", (int) y_db, (int) x_db);
-      UART_Transmit(uart_buf);
-    }
+  // LED1 shows lock
+  if (adc_sched.state == ACQ_LOCKED) {
+    LED_Set(LED1_PIN);
+  }
+  else {
+    LED_Reset(LED1_PIN);
+  }
+
+  // bursts are grouped into pulses and handed to a track when the pulse ends,
+  // report only when guidance ran for the selected track
+  int32_t k = tracker_push(&g_tracker, &g_tracker_params, tick, ev, powerx, powery, cross, sat);
+  if (ev == PULSE_RISE && g_rise_known) {
+    tracker_pulse_rise(&g_tracker, g_rise_ms);
+  }
+  track *sel = tracker_selected(&g_tracker);
+  if (k < 0 || sel != &g_tracker.tracks[k]) {
+    return;
+  }
+
+  // position estimate follows the selected track, restart when it changes,
+  // then move the particles by the turn just asked for. A clipped pulse is
+  // not weighed in, its power would read the beacon as further away
+  if (sel->id != g_pf_track) {
+    pf_init(&g_pf, sel->id);
+    g_pf_track = sel->id;
+  }
+  float nx = sel->smoothx.guide_out;
+  float ny = sel->smoothy.guide_out;
+  float nxy = sel->cross;
+  range_normalise(&nx, &ny, &nxy);
+  if (!sel->saturated) {
+    pf_update(&g_pf, &g_pf_params, nx, ny, nxy);
+  }
+  pf_predict(&g_pf, &g_pf_params, sel->out.heading_corr);
 
+  const char *dir_str = "????????";
+  switch(sel->out.dir) 
+  {
+    case STRAIGHT_AHEAD: dir_str = "FWD";     
+      break;
+    case TURN_LEFT:      dir_str = "LEFT";    
+      break;
+    case TURN_RIGHT:     dir_str = "RIGHT";   
+      break;
+    case TURN_AROUND:    dir_str = "UTURN";   
+      break;
+    case NO_SIGNAL:      dir_str = "NOSIGNAL";
+      break;
+  }
+
+  print_count++;
+  if (print_count == 10) {
+    print_count = 0;
+
+    // sliding max, tracked as the averages come in
+    float max_x = stats_window_max(&sel->avgx);
+    float max_y = stats_window_max(&sel->avgy);
+
+    float x_db = 10 * log10f(max_x);
+    float y_db = 10 * log10f(max_y);
+
+    const char *lock_str = adc_sched.state == ACQ_LOCKED ? "LOCK" : "SCAN";
+    const char *sat_str = sel->saturated ? " SAT" : "";
+
+    // heading correction in degrees, + is left
+    int heading_deg = (int) lrintf(sel->out.heading_corr * 57.29578f);
+    int conf_pct = (int) lrintf(sel->out.confidence * 100);
+
+    // distances in tenths of a metre, printf has no float support: range
+    // straight from the calibrated power, dist from the particle filter
+    int range_dm = (int) lrintf(range_lookup(nx + ny) * 10);
+    pf_estimate est = pf_get_estimate(&g_pf);
+    int dist_dm = (int) lrintf(est.range_m * 10);
+    int spread_dm = (int) lrintf(est.spread_m * 10);
+
+    snprintf(uart_buf, 1000, "track %lu of %lu; parallel dB: %2d; perpindicular dB: %2d; %s %+4d deg (%3d%%); range: %d.%d m; dist: %d.%d m (+-%d.%d); %s%s period: %4d ms; freq: %+d Hz%s; coh: %+d dB; dc: %d/%d; width: %ld us\r\n",
+             sel->id, tracker_count(&g_tracker), (int) y_db, (int) x_db, dir_str, heading_deg, conf_pct,
+             range_dm / 10, range_dm % 10, dist_dm / 10, dist_dm % 10, spread_dm / 10, spread_dm % 10, lock_str, sat_str, (int) sel->period,
+             (int) lrintf(g_freq.offset_hz), freq_rect(&g_freq) ? " RECT" : "", (int) lrintf(g_coh_res.gain_db),
+             dsp_dc_get(&g_dcx), dsp_dc_get(&g_dcy), g_width_us);
+    UART_Transmit(uart_buf);
   }
 }
 
 /*
-* Calculate power of input samples, and save in power buffer.
+* Calculate the complex 457 kHz bin of input samples.
+*
+* Both channels are sampled together, so the phase between their bins is
+* meaningful. ADC2 starts a few cycles after ADC1, a small fixed offset that
+* does not change the sign of the cross term.
+*
+* The raw sample range, clipped count and sum come back in st, taken in the
+* same pass as the windowing and the bins. The sum moves the channel's dc estimate on,
+* for the next burst. The bin is at the tracked carrier frequency, the
+* power of it and the two side bins is added to power. While the carrier is
+* found on the bin centre the window is skipped, see freq.h.
+*
+* With g_edges set the burst's sliding DFT powers are added to this burst's
+* edge powers first.
 */
-void power_calc(int16_t *buf, circ_buf_float *pbuf)
+dsp_complex bin_calc(int16_t *buf, dsp_dc_tracker *dc, sdft_state *sd, dsp_clip_stats *st, float *power)
 {
-  // subtract away dc op point and apply window
-  for (int i = 0; i < BUF_SIZE; i+=2) {
-    int32_t intres0 = (buf[i] - 2048) * flattop_int16_3600[i];
-    int32_t intres1 = (buf[i+1] - 2048) * flattop_int16_3600[i+1];
-
-    // shift back into 16 bit range
-    buf[i] = intres0 >> 12;
-    buf[i+1] = intres1 >> 12;
+  dsp_complex bins[FREQ_BINS];
+
+  // power through the burst for the edge search, from the raw samples
+  if (g_edges) {
+    dsp_complex z[EDGE_OUTS];
+    sdft_reset(sd);
+    uint32_t m = sdft_process(sd, buf, BUF_SIZE, dsp_dc_get(dc), z);
+    for (uint32_t j = 0; j < m; j++) {
+      g_edge_power[g_edge_cur][j] += dsp_power(z[j]);
+    }
   }
 
-  // calc power at 457 kHz
-  float power = goertzel_power_457k(buf);
-  // clamp to 1 (to avoid negative power dB readings)
-  if (power < 1) {
-    power = 1;
+  if (freq_rect(&g_freq)) {
+    // carrier on the bin centre, no window needed: bins straight from the
+    // raw samples less the dc op point
+    goertzel_bin_multibin_raw(g_freq.plans, FREQ_BINS, buf, dsp_dc_get(dc), g_rect_gain, st, bins);
   }
-
-  // convert power to dB
-  // float power_db = 10 * log10f(power);
-
-  // save in buffer 
-  circ_buf_wr_float(pbuf, power);
+  else {
+    // window less the dc op point and the bins around 457 kHz in one fixed
+    // point pass, the windowed samples keep their low bits
+    goertzel_bin_multibin_fused_q31(g_freq.plans, FREQ_BINS, buf, BURST_WINDOW, dsp_dc_get(dc), DSP_Q31_HEADROOM,
+                                    st, bins);
+  }
+  dsp_dc_update(dc, st, BUF_SIZE);
+  for (uint32_t b = 0; b < FREQ_BINS; b++) {
+    power[b] += dsp_power(bins[b]);
+  }
+  return bins[FREQ_CENTRE];
 }
 
 /*
-* Take the average of the power buffer and save in average power buffer.
+* Place the pulse edges to within microseconds when they fall inside a burst.
+*
+* The burst scheduler runs a burst every few ms, so the pulse detector only
+* sees an edge to within the burst period. A rise is searched for in the
+* burst that raised PULSE_RISE, then the one before; a fall in the burst
+* that raised PULSE_FALL, then the last one still on. The rise is handed
+* to the tracker as the pulse's time, the width is kept when both edges were
+* found.
 */
-void avg_power(float *pbuf, circ_buf_float *avg_pbuf)
+void edge_update(pulse_event ev, uint32_t tick, uint32_t cycles)
 {
-  // calc average of power buffer
-  float sum = 0;
+  const float cycles_per_sample = SystemCoreClock / ACQ_FS_HZ;
+  uint32_t cur = g_edge_cur;
+  uint32_t prev = cur ^ 1;
+  g_edge_cycles[cur] = cycles;
+  g_edge_valid[cur] = true;
+
+  if (ev == PULSE_RISE || ev == PULSE_FALL) {
+    bool rising = ev == PULSE_RISE;
+    bool found = false;
+    uint32_t at = 0;
+    for (uint32_t k = 0; k < 2 && !found; k++) {
+      uint32_t b = k == 0 ? cur : prev;
+      float e = g_edge_valid[b] ? sdft_edge(g_edge_power[b], EDGE_OUTS, EDGE_LEN, EDGE_HOP, rising) : -1;
+      if (e >= 0) {
+        found = true;
+        at = g_edge_cycles[b] + (uint32_t) lrintf(e * cycles_per_sample);
+      }
+    }
 
-  for (int i = 0; i < POWER_BUF_SIZE; i++) {
-    sum += pbuf[i];
+    if (rising) {
+      g_rise_known = found;
+      g_rise_cycles = at;
+      // the edge can be in the burst before, at a negative offset
+      g_rise_ms = tick + (int32_t) lrintf((int32_t) (at - cycles) / (SystemCoreClock / 1e3f));
+    }
+    else {
+      g_width_us = found && g_rise_known ? (int32_t) lrintf((at - g_rise_cycles) / (SystemCoreClock / 1e6f)) : -1;
+      g_rise_known = false;
+    }
   }
-  float avg = sum / POWER_BUF_SIZE;
 
-  // save average in average power buffer
-  circ_buf_wr_float(avg_pbuf, avg);
+  g_edge_cur = prev;
+}
+
+/*
+* Survey the X channel's spectrum and print it.
+*
+* The FFT works in place on the X buffer with the Y buffer as its output,
+* so the burst is used up and dropped from tracking.
+*/
+void spectrum_survey(void)
+{
+  while(!inbufx_rdy || !inbufy_rdy);
+  uint32_t start = DWT->CYCCNT;
+  spec_run((int16_t*) inbufx, (int16_t*) inbufy, BURST_WINDOW, BUF_SIZE, dsp_dc_get(&g_dcx), ACQ_FS_HZ, &g_spec);
+  uint32_t cost = DWT->CYCCNT - start;
+  inbufx_rdy = 0;
+  inbufy_rdy = 0;
+
+  int n = snprintf(uart_buf, 1000, "spec: %d Hz/band; peak %d Hz %d dB; %lu cycles; dB:",
+                   (int) lrintf(g_spec.band_hz), (int) lrintf(g_spec.peak_hz), (int) lrintf(g_spec.peak_db), cost);
+  for (uint32_t b = 0; b < SPEC_BANDS && n < 990; b++) {
+    n += snprintf(uart_buf + n, 1000 - n, " %d", (int) lrintf(g_spec.db[b]));
+  }
+  snprintf(uart_buf + n, 1000 - n, "\r\n");
+  UART_Transmit(uart_buf);
 }
@@ -0,0 +1,426 @@
+#include "bench_kernels.h"
+#include "dsp.h"
+#include "globals.h"
+#include "power.h"
+#include "circ_buf.h"
+#include "guidance.h"
+#include "pf.h"
+#include "range.h"
+#include "range_cal.h"
+#include "ddc.h"
+#include "sdft.h"
+#include "spectrum.h"
+#include "stats.h"
+#include <math.h>
+#include <string.h>
+
+#define BENCH_N BUF_SIZE
+#define BENCH_FS ACQ_FS_HZ
+#define BENCH_FREQ ACQ_IF_HZ
+#define BENCH_CIRC_OPS 4096
+#define BENCH_STATS_OPS 4096
+#define BENCH_SMOOTH_OPS 4096
+#define BENCH_GUIDANCE_STEPS 256
+#define BENCH_RANGE_OPS 4096
+
+/*********************
+ * Fixed input vectors
+ * ******************/
+
+static int16_t rawx[BENCH_N];
+static int16_t rawy[BENCH_N];
+static int16_t windowed[BENCH_N];
+static int16_t windowed_y[BENCH_N];
+static int16_t work[BENCH_N];
+static int16_t window[BENCH_N];
+
+// the window's coherent gain on the >> 12 scale, for the unwindowed bins
+static float rect_gain;
+
+static goertzel_plan plan;
+static goertzel_plan plans3[3];
+static ddc_state ddc;
+static ddc_iq ddc_out[BENCH_N / DDC_DECIM + 1];
+static sdft_state sdft;
+static dsp_complex sdft_out[BENCH_N];
+static int16_t spec_out[2 * SPEC_N];
+static spec_result spec;
+
+static power_smoother smooth_box;
+static power_smoother smooth_ema;
+static const smooth_cfg smooth_box_cfg =
+{
+  .burst = {.mode = SMOOTH_BOXCAR, .tau = 0, .len = POWER_BUF_SIZE},
+  .guide = {.mode = SMOOTH_NONE,   .tau = 0, .len = 1},
+  .decim = POWER_BUF_SIZE
+};
+static const smooth_cfg smooth_ema_cfg =
+{
+  .burst = {.mode = SMOOTH_EMA, .tau = POWER_BUF_SIZE, .len = 1},
+  .guide = {.mode = SMOOTH_CIC, .tau = 0,              .len = 4},
+  .decim = POWER_BUF_SIZE
+};
+static float avgpowerbuf[POWER_AVG_BUF_SIZE];
+static uint32_t avgpowerq[2][POWER_AVG_BUF_SIZE];
+static stats_window avgpowerstat;
+static float circbuf[POWER_AVG_BUF_SIZE];
+static circ_buf_float circ;
+
+static float gbufx[BENCH_GUIDANCE_STEPS];
+static float gbufy[BENCH_GUIDANCE_STEPS];
+static GuidanceState guidance_state;
+static pf_filter bench_pf;
+static const pf_params bench_pf_params =
+{
+  .moment      = 1.0f,
+  .depth_m     = 1.0f,
+  .range_min_m = 0.5f,
+  .range_max_m = 60.0f,
+  .step_m      = 0.5f,
+  .pos_sigma_m = 0.3f,
+  .turn_sigma  = 0.05f,
+  .mag_sigma   = 0.2f,
+  .ang_sigma   = 0.2f
+};
+static GuidanceParams guidance_params =
+{
+  .buf_size      = BENCH_GUIDANCE_STEPS,
+  .hist_size     = POWER_AVG_BUF_SIZE,
+  .drop_steps    = 10,
+  .reverse_cd    = 40,
+  .fwd_thresh    = 3.14159265/8.0f,
+  .min_valid_mag = 4.0f
+};
+
+static uint32_t lcg_state;
+
+/*
+ * Deterministic pseudo random noise in [-amp, amp].
+ */
+static int32_t bench_noise(int32_t amp)
+{
+  lcg_state = lcg_state * 1664525u + 1013904223u;
+  return ((int32_t) (lcg_state >> 16) % (2 * amp + 1)) - amp;
+}
+
+/*
+ * Fill the input vectors. Always produces the same data so results can be
+ * compared between builds.
+ */
+void bench_init(void)
+{
+  const float pi = 3.14159265f;
+
+  lcg_state = 12345;
+
+  for (uint32_t i = 0; i < BENCH_N; i++) {
+    float phase = 2 * pi * BENCH_FREQ * i / BENCH_FS;
+    rawx[i] = 2048 + (int16_t) (1200 * cosf(phase)) + bench_noise(40);
+    rawy[i] = 2048 + (int16_t) (300 * sinf(phase)) + bench_noise(40);
+
+    // flattop window in Q15
+    float t = 2 * pi * i / (BENCH_N - 1);
+    float w = 0.21557895f - 0.41663158f * cosf(t) + 0.277263158f * cosf(2 * t)
+              - 0.083578947f * cosf(3 * t) + 0.006947368f * cosf(4 * t);
+    window[i] = (int16_t) (w * 32767);
+  }
+
+  // as the firmware's g_rect_gain
+  rect_gain = 0;
+  for (uint32_t i = 0; i < BENCH_N; i++) {
+    rect_gain += window[i];
+  }
+  rect_gain /= 4096.0f * BENCH_N;
+
+  goertzel_plan_init(&plan, BENCH_FREQ, BENCH_FS, BENCH_N);
+  ddc_init(&ddc, BENCH_FREQ, BENCH_FS);
+  sdft_init(&sdft, BENCH_FREQ, BENCH_FS, BENCH_N / 10, BENCH_N / 40, SDFT_DAMPING);
+  spec_init();
+  for (int32_t b = 0; b < 3; b++) {
+    goertzel_plan_init_bin(&plans3[b], plan.k - 1 + b, BENCH_N);
+  }
+
+  memcpy(windowed, rawx, sizeof(windowed));
+  dsp_window_q15(windowed, window, BENCH_N, 2048);
+  memcpy(windowed_y, rawy, sizeof(windowed_y));
+  dsp_window_q15(windowed_y, window, BENCH_N, 2048);
+
+  stats_window_init(&avgpowerstat, avgpowerbuf, avgpowerq[0], avgpowerq[1], POWER_AVG_BUF_SIZE);
+  power_smoother_init(&smooth_box, &smooth_box_cfg);
+  power_smoother_init(&smooth_ema, &smooth_ema_cfg);
+  circ_buf_init_float(&circ, circbuf, POWER_AVG_BUF_SIZE);
+
+  // slowly rising signal with the field swinging across the antennas
+  for (uint32_t i = 0; i < BENCH_GUIDANCE_STEPS; i++) {
+    float mag = 100.0f + i + bench_noise(20);
+    float ang = 0.01f * i;
+    gbufx[i] = mag * cosf(ang);
+    gbufy[i] = mag * sinf(ang);
+  }
+}
+
+/*********************
+ * Kernels
+ * ******************/
+
+static void prepare_work(void)
+{
+  memcpy(work, rawx, sizeof(work));
+}
+
+static float run_window_q15(void)
+{
+  dsp_window_q15(work, window, BENCH_N, 2048);
+  return work[BENCH_N / 2];
+}
+
+// windowing with the clip statistics, should cost next to nothing extra
+static float run_window_q15_stats(void)
+{
+  dsp_clip_stats st;
+  dsp_window_q15_stats(work, window, BENCH_N, 2048, &st);
+  return work[BENCH_N / 2] + st.max + st.clipped;
+}
+
+static float run_goertzel_f32(void)
+{
+  return goertzel_power_f32(&plan, windowed);
+}
+
+// both channels' bins, two calls against one interleaved loop
+static float run_goertzel_f32_x2(void)
+{
+  return goertzel_power_f32(&plan, windowed) + goertzel_power_f32(&plan, windowed_y);
+}
+
+static float run_goertzel_dual(void)
+{
+  float px;
+  float py;
+  goertzel_power_dual(&plan, windowed, windowed_y, &px, &py);
+  return px + py;
+}
+
+static float run_goertzel_q31(void)
+{
+  return goertzel_power_q31(&plan, windowed);
+}
+
+static float run_goertzel_fused(void)
+{
+  return goertzel_power_fused(&plan, rawx, window, 2048);
+}
+
+// fused in fixed point, no truncation of the windowed samples
+static float run_goertzel_fused_q31(void)
+{
+  return goertzel_power_fused_q31(&plan, rawx, window, 2048, DSP_Q31_HEADROOM);
+}
+
+// the application's per burst path, window then the 457 kHz bin
+static float run_goertzel_457k(void)
+{
+  dsp_window_q15(work, window, BENCH_N, 2048);
+  return goertzel_power_457k(work);
+}
+
+static void prepare_ddc(void)
+{
+  ddc_reset(&ddc);
+}
+
+// same burst through the downconverter, BENCH_N / DDC_DECIM I/Q outputs
+static float run_ddc_block(void)
+{
+  uint32_t n = ddc_process(&ddc, rawx, BENCH_N, 2048, ddc_out);
+  return ddc_power(ddc_out, n);
+}
+
+// sliding DFT over the burst as the edge search runs it, cost per sample
+static float run_sdft_block(void)
+{
+  sdft_reset(&sdft);
+  uint32_t n = sdft_process(&sdft, rawx, BENCH_N, 2048, sdft_out);
+  return sdft_out[n - 1].re;
+}
+
+// one spectrum survey, the target's cost is arm_rfft_q15 where this
+// measures the Goertzel fallback
+static float run_spectrum_survey(void)
+{
+  spec_run(work, spec_out, window, BENCH_N, 2048, BENCH_FS, &spec);
+  return spec.peak_db;
+}
+
+// complex bins, what the carrier tracking runs on every burst
+static float run_goertzel_bin3(void)
+{
+  dsp_complex z[3];
+  goertzel_bin_multibin(plans3, 3, windowed, z);
+  return z[0].re + z[1].re + z[2].re;
+}
+
+// a burst's three bins: windowed with the clip statistics then the float
+// recurrence, the same in one fixed point pass as bin_calc() takes them, or
+// unwindowed on a bin centred carrier
+static float run_burst_bin3(void)
+{
+  dsp_clip_stats st;
+  dsp_complex z[3];
+  dsp_window_q15_stats(work, window, BENCH_N, 2048, &st);
+  goertzel_bin_multibin(plans3, 3, work, z);
+  return z[0].re + z[1].re + z[2].re + st.sum;
+}
+
+static float run_burst_bin3_q31(void)
+{
+  dsp_clip_stats st;
+  dsp_complex z[3];
+  goertzel_bin_multibin_fused_q31(plans3, 3, rawx, window, 2048, DSP_Q31_HEADROOM, &st, z);
+  return z[0].re + z[1].re + z[2].re + st.sum;
+}
+
+static float run_burst_bin3_raw(void)
+{
+  dsp_clip_stats st;
+  dsp_complex z[3];
+  goertzel_bin_multibin_raw(plans3, 3, rawx, 2048, rect_gain, &st, z);
+  return z[0].re + z[1].re + z[2].re + st.sum;
+}
+
+static float run_goertzel_multibin3(void)
+{
+  float power[3];
+  goertzel_power_multibin(plans3, 3, windowed, power);
+  return power[0] + power[1] + power[2];
+}
+
+// window then Goertzel, as done per channel by power_calc()
+static float run_power_calc(void)
+{
+  dsp_window_q15(work, window, BENCH_N, 2048);
+  return goertzel_power_f32(&plan, work);
+}
+
+static float run_smooth(power_smoother *ps)
+{
+  float sum = 0;
+  for (uint32_t i = 0; i < BENCH_SMOOTH_OPS; i++) {
+    power_smoother_push(ps, 1000.0f + (float) bench_noise(100));
+    sum += ps->guide_out;
+  }
+  return sum;
+}
+
+static float run_smooth_boxcar(void)
+{
+  return run_smooth(&smooth_box);
+}
+
+static float run_smooth_ema_cic(void)
+{
+  return run_smooth(&smooth_ema);
+}
+
+static float run_stats_window(void)
+{
+  float sum = 0;
+  for (uint32_t i = 0; i < BENCH_STATS_OPS; i++) {
+    stats_window_push(&avgpowerstat, (float) bench_noise(1000));
+    sum += stats_window_mean(&avgpowerstat) + stats_window_max(&avgpowerstat);
+  }
+  return sum;
+}
+
+static float run_circ_buf(void)
+{
+  float sum = 0;
+  for (uint32_t i = 0; i < BENCH_CIRC_OPS; i++) {
+    circ_buf_wr_float(&circ, (float) i);
+    sum += circ_buf_rd_float(&circ);
+  }
+  return sum;
+}
+
+// every run starts from a fresh history and no U-turn in progress
+static void prepare_guidance(void)
+{
+  guidance_state_init(&guidance_state, &guidance_params);
+}
+
+static float run_guidance_step(void)
+{
+  float sum = 0;
+  for (uint32_t i = 0; i < BENCH_GUIDANCE_STEPS; i++) {
+    // position is one past the sample to read
+    sum += guidance_step(gbufx, gbufy, i + 1, i + 1, &guidance_state, &guidance_params);
+  }
+  return sum;
+}
+
+// filter seeded from one reading, each run is one guidance update
+static void prepare_pf(void)
+{
+  pf_init(&bench_pf, 1);
+  pf_update(&bench_pf, &bench_pf_params, 1e-3f, 2e-4f, 1e-4f);
+}
+
+static float run_pf_step(void)
+{
+  pf_update(&bench_pf, &bench_pf_params, 1.1e-3f, 2e-4f, 1e-4f);
+  pf_predict(&bench_pf, &bench_pf_params, 0.1f);
+  return pf_get_estimate(&bench_pf).range_m;
+}
+
+// power to distance over a sweep of powers, table against the maths it replaces
+static float run_range_lookup(void)
+{
+  float sum = 0, pw = 1e6f;
+  for (uint32_t i = 0; i < BENCH_RANGE_OPS; i++) {
+    sum += range_from_power(pw, pw);
+    pw *= 1.01f;
+  }
+  return sum;
+}
+
+static float run_range_log10f(void)
+{
+  float sum = 0, pw = 1e6f;
+  for (uint32_t i = 0; i < BENCH_RANGE_OPS; i++) {
+    float db = 10 * log10f(pw * RANGE_CAL_SCALE_X + pw * RANGE_CAL_SCALE_Y);
+    sum += powf(10.0f, -db / (10 * RANGE_CAL_EXPONENT));
+    pw *= 1.01f;
+  }
+  return sum;
+}
+
+const bench_kernel bench_kernels[] = {
+  {"window_q15",         BENCH_N,              prepare_work,     run_window_q15},
+  {"window_q15_stats",   BENCH_N,              prepare_work,     run_window_q15_stats},
+  {"goertzel_f32",       BENCH_N,              NULL,             run_goertzel_f32},
+  {"goertzel_f32_x2",    2 * BENCH_N,          NULL,             run_goertzel_f32_x2},
+  {"goertzel_dual",      2 * BENCH_N,          NULL,             run_goertzel_dual},
+  {"goertzel_q31",       BENCH_N,              NULL,             run_goertzel_q31},
+  {"goertzel_fused",     BENCH_N,              NULL,             run_goertzel_fused},
+  {"goertzel_fused_q31", BENCH_N,              NULL,             run_goertzel_fused_q31},
+  {"goertzel_457k",      BENCH_N,              prepare_work,     run_goertzel_457k},
+  {"ddc_block",          BENCH_N,              prepare_ddc,      run_ddc_block},
+  {"sdft_block",         BENCH_N,              NULL,             run_sdft_block},
+  {"spectrum_survey",    SPEC_N,               prepare_work,     run_spectrum_survey},
+  {"goertzel_multibin3", BENCH_N,              NULL,             run_goertzel_multibin3},
+  {"goertzel_bin3",      BENCH_N,              NULL,             run_goertzel_bin3},
+  {"burst_bin3",         BENCH_N,              prepare_work,     run_burst_bin3},
+  {"burst_bin3_q31",     BENCH_N,              NULL,             run_burst_bin3_q31},
+  {"burst_bin3_raw",     BENCH_N,              NULL,             run_burst_bin3_raw},
+  {"power_calc",         BENCH_N,              prepare_work,     run_power_calc},
+  {"smooth_boxcar",      BENCH_SMOOTH_OPS,     NULL,             run_smooth_boxcar},
+  {"smooth_ema_cic",     BENCH_SMOOTH_OPS,     NULL,             run_smooth_ema_cic},
+  {"stats_window_push",  BENCH_STATS_OPS,      NULL,             run_stats_window},
+  {"circ_buf_wr_rd",     BENCH_CIRC_OPS,       NULL,             run_circ_buf},
+  {"guidance_step",      BENCH_GUIDANCE_STEPS, prepare_guidance, run_guidance_step},
+  {"pf_step",            PF_NUM,               prepare_pf,       run_pf_step},
+  {"range_lookup",       BENCH_RANGE_OPS,      NULL,             run_range_lookup},
+  {"range_log10f",       BENCH_RANGE_OPS,      NULL,             run_range_log10f},
+};
+
+const uint32_t bench_kernel_count = sizeof(bench_kernels) / sizeof(bench_kernels[0]);
@@ -0,0 +1,140 @@
+/*
+ * DSP benchmark firmware.
+ *
+ * Replaces the application's app_main(). Every kernel in bench_kernels is run
+ * with caches on and then off, and one JSON object per kernel is printed over
+ * UART. Timing uses the DWT cycle counter with interrupts masked.
+ */
+#include "main.h"
+#include "led.h"
+#include "stm32f722xx.h"
+#include "stm32f7xx_nucleo_144.h"
+#include <stdint.h>
+#include <stm32f7xx_hal.h>
+#include "dwt.h"
+#include "globals.h"
+#include "UART.h"
+#include <stdio.h>
+#include "bench_kernels.h"
+
+/***********************
+ * Defines
+ * ********************/
+
+#define BENCH_REPS 20
+
+#ifndef BENCH_BUILD_TYPE
+#define BENCH_BUILD_TYPE "unknown"
+#endif
+
+/*********************
+ * Globals
+ * ******************/
+
+// flag to tell if configuration complete (ADC bursts stay off in the benchmark)
+volatile int config_cplt;
+
+// buffer for usart transmit
+char uart_buf[256];
+
+// keeps kernel results alive
+volatile float bench_sink;
+
+/*************************
+ * Function prototypes.
+ * **********************/
+
+void bench_print(const char *str);
+void bench_run_all(const char *cache);
+
+/***************************
+ * Functions
+ * *************************/
+
+void app_main(void)
+{
+  config_cplt = 0;
+
+  // configure peripherals
+  LED_Init();
+  DWT_Init();
+  UART_Config();
+
+  bench_init();
+
+  snprintf(uart_buf, sizeof(uart_buf),
+           "{\"target\":\"stm32f722\",\"cpu_hz\":%lu,\"build\":\"%s\",\"reps\":%d}\r\n",
+           SystemCoreClock, BENCH_BUILD_TYPE, BENCH_REPS);
+  bench_print(uart_buf);
+
+  // caches on
+  SCB_EnableICache();
+  SCB_EnableDCache();
+  bench_run_all("on");
+
+  // caches off
+  SCB_DisableDCache();
+  SCB_DisableICache();
+  bench_run_all("off");
+
+  bench_print("{\"done\":true}\r\n");
+
+  while (1)
+  {
+    LED_Toggle(LED2_PIN);
+    HAL_Delay(500);
+  }
+}
+
+/*
+ * Blocking UART print, waits for any previous transfer.
+ */
+void bench_print(const char *str)
+{
+  while (tx_in_progress);
+  UART_Transmit(str);
+  while (tx_in_progress);
+}
+
+/*
+ * Time every kernel and print the result as one JSON line each.
+ */
+void bench_run_all(const char *cache)
+{
+  for (uint32_t k = 0; k < bench_kernel_count; k++) {
+    const bench_kernel *kern = &bench_kernels[k];
+    uint32_t min = UINT32_MAX;
+    uint32_t total = 0;
+
+    // first run is a warm up and is not counted
+    for (int rep = -1; rep < BENCH_REPS; rep++) {
+      if (kern->prepare) {
+        kern->prepare();
+      }
+
+      __disable_irq();
+      uint32_t start = DWT_GetCount();
+      bench_sink = kern->run();
+      uint32_t cycles = DWT_GetCount() - start;
+      __enable_irq();
+
+      if (rep < 0) {
+        continue;
+      }
+      total += cycles;
+      if (cycles < min) {
+        min = cycles;
+      }
+    }
+
+    uint32_t avg = total / BENCH_REPS;
+    // cycles per sample with three decimals, printf has no float support
+    uint32_t cps_milli = (uint32_t) (((uint64_t) min * 1000) / kern->samples);
+
+    snprintf(uart_buf, sizeof(uart_buf),
+             "{\"kernel\":\"%s\",\"cache\":\"%s\",\"samples\":%lu,\"cycles_min\":%lu,\"cycles_avg\":%lu,"
+             "\"cycles_per_sample\":%lu.%03lu}\r\n",
+             kern->name, cache, kern->samples, min, avg, cps_milli / 1000, cps_milli % 1000);
+    bench_print(uart_buf);
+  }
+}
@@ -0,0 +1,161 @@
+#include "cfar.h"
+#include <math.h>
+
+// integration steps over the floor for looks > 1
+#define CFAR_STEPS 1024
+
+/*
+ * log P(X > t) for X the sum of looks unit mean exponentials (Gamma(looks)):
+ * e^-t sum_{j<looks} t^j / j!
+ * Past t = looks the sum is taken from its largest term down, relative to
+ * it, so t^j can't overflow.
+ */
+static float cfar_log_tail(float t, uint32_t looks)
+{
+  float term = 1;
+  float sum = 1;
+  if (t <= looks) {
+    for (uint32_t j = 1; j < looks; j++) {
+      term *= t / j;
+      sum += term;
+    }
+    return logf(sum) - t;
+  }
+
+  for (uint32_t j = looks - 1; j > 0; j--) {
+    term *= j / t;
+    sum += term;
+  }
+  return logf(sum) + (looks - 1) * logf(t) - lgammaf((float) looks) - t;
+}
+
+/*
+ * False alarm probability of an ordered statistic CFAR for a threshold
+ * factor alpha. With exponential noise (looks of 1) tested one reading at a
+ * time it is
+ *
+ *   pfa = prod_{i=0}^{rank-1} (window - i) / (window - i + alpha)
+ *
+ * otherwise the tail of a tested value over alpha times the floor is
+ * integrated over the density of the rank-th of window readings:
+ *
+ *   pfa = int P(T > alpha z) f_rank(z) dz
+ *   f_rank(z) = rank C(window, rank) F(z)^(rank-1) (1 - F(z))^(window-rank) f(z)
+ *
+ * in the log domain, as F(z)^(rank-1) underflows. T, the mean of avg
+ * readings, is Gamma(looks * avg) over avg.
+ */
+float cfar_pfa(uint32_t window, uint32_t rank, uint32_t looks, uint32_t avg, float alpha)
+{
+  if (looks < 1) looks = 1;
+  if (avg < 1) avg = 1;
+
+  if (looks == 1 && avg == 1) {
+    float lp = 0;
+    for (uint32_t i = 0; i < rank; i++) {
+      float m = (float) (window - i);
+      lp += logf(m / (m + alpha));
+    }
+    return expf(lp);
+  }
+
+  float lcoef = lgammaf(window + 1.0f) - lgammaf((float) rank) - lgammaf(window - rank + 1.0f)
+                - lgammaf((float) looks);
+  float zmax = 30.0f + 10.0f * looks;
+  float h = zmax / CFAR_STEPS;
+  float sum = 0;
+
+  // Simpson's rule, the integrand is 0 at z = 0
+  for (uint32_t i = 1; i <= CFAR_STEPS; i++) {
+    float z = i * h;
+    float ls = cfar_log_tail(z, looks);
+    float lf = (looks - 1) * logf(z) - z;
+    float l = lcoef + lf + cfar_log_tail(avg * alpha * z, looks * avg);
+    if (rank > 1) {
+      l += (rank - 1) * log1pf(-expf(ls));
+    }
+    if (window > rank) {
+      l += (window - rank) * ls;
+    }
+    float wgt = i == CFAR_STEPS ? 1.0f : (i & 1) ? 4.0f : 2.0f;
+    sum += wgt * expf(l);
+  }
+  return sum * h / 3;
+}
+
+/*
+ * Threshold factor for the wanted pfa, by bisection on the log.
+ */
+float cfar_alpha(uint32_t window, uint32_t rank, uint32_t looks, uint32_t avg, float pfa)
+{
+  float target = logf(pfa);
+  float lo = 0.0f;
+  float hi = 1e4f;
+
+  for (uint32_t it = 0; it < 40; it++) {
+    float a = 0.5f * (lo + hi);
+    // pfa falls as alpha grows
+    if (logf(cfar_pfa(window, rank, looks, avg, a)) > target) {
+      lo = a;
+    }
+    else {
+      hi = a;
+    }
+  }
+  return 0.5f * (lo + hi);
+}
+
+void cfar_init(cfar_detector *cf, const cfar_params *p)
+{
+  cf->window = p->window;
+  if (cf->window < 1) cf->window = 1;
+  if (cf->window > CFAR_WINDOW) cf->window = CFAR_WINDOW;
+  cf->rank = p->rank;
+  if (cf->rank < 1) cf->rank = 1;
+  if (cf->rank > cf->window) cf->rank = cf->window;
+
+  cf->alpha = cfar_alpha(cf->window, cf->rank, p->looks, p->avg, p->pfa);
+  cf->n = 0;
+  cf->head = 0;
+}
+
+/*
+ * Add a noise reading, dropping the oldest once the window is full.
+ */
+void cfar_push(cfar_detector *cf, float noise)
+{
+  uint32_t n = cf->n;
+
+  if (n == cf->window) {
+    // take the oldest out of the sorted list
+    float old = cf->ring[cf->head];
+    uint32_t i = 0;
+    while (i < n - 1 && cf->sorted[i] != old) {
+      i++;
+    }
+    for (; i < n - 1; i++) {
+      cf->sorted[i] = cf->sorted[i + 1];
+    }
+    n--;
+  }
+
+  // insert in order
+  uint32_t i = n;
+  while (i > 0 && cf->sorted[i - 1] > noise) {
+    cf->sorted[i] = cf->sorted[i - 1];
+    i--;
+  }
+  cf->sorted[i] = noise;
+
+  cf->ring[cf->head] = noise;
+  cf->head = (cf->head + 1) % cf->window;
+  cf->n = n + 1;
+}
+
+/*
+ * Detection threshold, alpha times the rank-th smallest reading.
+ */
+float cfar_threshold(const cfar_detector *cf)
+{
+  return cf->alpha * cfar_floor(cf);
+}
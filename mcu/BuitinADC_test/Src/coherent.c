@@ -0,0 +1,109 @@
+#include "coherent.h"
+#include <math.h>
+
+#define COH_TWO_PI 6.28318531f
+
+/*
+ * z * exp(-j a)
+ */
+static inline dsp_complex coh_rotate(dsp_complex z, float a)
+{
+  float c = cosf(a);
+  float s = sinf(a);
+  dsp_complex r = {z.re * c + z.im * s, z.im * c - z.re * s};
+  return r;
+}
+
+/*
+ * Start a pulse whose first burst began at DWT count t.
+ */
+void coh_start(coh_integrator *ci, float carrier_hz, float cpu_hz, uint32_t t)
+{
+  ci->cpu_hz = cpu_hz;
+  ci->step = (uint32_t) lrintf(carrier_hz / cpu_hz * 4294967296.0f);
+  ci->t0 = t;
+  ci->n = 0;
+}
+
+/*
+ * Add the X and Y bins of a burst that began at DWT count t.
+ */
+void coh_push(coh_integrator *ci, uint32_t t, dsp_complex x, dsp_complex y)
+{
+  if (ci->n == COH_MAX_BURSTS) {
+    return;
+  }
+
+  // turns of the carrier since the first burst, the product wraps to the
+  // fraction of a turn
+  uint32_t dt = t - ci->t0;
+  float a = (float) (ci->step * dt) * (COH_TWO_PI / 4294967296.0f);
+
+  ci->t[ci->n] = dt;
+  ci->x[ci->n] = coh_rotate(x, a);
+  ci->y[ci->n] = coh_rotate(y, a);
+  ci->n++;
+}
+
+/*
+ * Residual offset from the phase steps between bursts, each step weighted
+ * by the bins' size.
+ */
+static float coh_offset(const coh_integrator *ci)
+{
+  float sum = 0;
+  float wsum = 0;
+
+  for (uint32_t b = 1; b < ci->n; b++) {
+    const dsp_complex *x = ci->x;
+    const dsp_complex *y = ci->y;
+
+    // z[b] * conj(z[b-1]) over both channels
+    float re = x[b].re * x[b - 1].re + x[b].im * x[b - 1].im + y[b].re * y[b - 1].re + y[b].im * y[b - 1].im;
+    float im = x[b].im * x[b - 1].re - x[b].re * x[b - 1].im + y[b].im * y[b - 1].re - y[b].re * y[b - 1].im;
+    float w = hypotf(re, im);
+    float dt = (ci->t[b] - ci->t[b - 1]) / ci->cpu_hz;
+    if (w > 0 && dt > 0) {
+      sum += w * atan2f(im, re) / (COH_TWO_PI * dt);
+      wsum += w;
+    }
+  }
+  return wsum > 0 ? sum / wsum : 0.0f;
+}
+
+/*
+ * Sum the pulse's bins with the residual offset taken out.
+ */
+coh_result coh_finish(const coh_integrator *ci)
+{
+  coh_result r = {0, 0, 0, 0, 0, 0, 0};
+  uint32_t n = ci->n;
+  if (n == 0) {
+    return r;
+  }
+
+  r.n = n;
+  r.offset_hz = coh_offset(ci);
+
+  dsp_complex sx = {0, 0};
+  dsp_complex sy = {0, 0};
+  float incoh = 0;
+  for (uint32_t b = 0; b < n; b++) {
+    float a = COH_TWO_PI * r.offset_hz * (ci->t[b] / ci->cpu_hz);
+    dsp_complex x = coh_rotate(ci->x[b], a);
+    dsp_complex y = coh_rotate(ci->y[b], a);
+    sx.re += x.re;
+    sx.im += x.im;
+    sy.re += y.re;
+    sy.im += y.im;
+    incoh += dsp_power(x) + dsp_power(y);
+  }
+
+  float n2 = (float) n * n;
+  r.px = dsp_power(sx) / n2;
+  r.py = dsp_power(sy) / n2;
+  r.pxy = dsp_cross(sx, sy) / n2;
+  r.coherence = incoh > 0 ? (dsp_power(sx) + dsp_power(sy)) / (n * incoh) : 0.0f;
+  r.gain_db = r.coherence > 0 ? 10 * log10f(n * r.coherence) : 0.0f;
+  return r;
+}
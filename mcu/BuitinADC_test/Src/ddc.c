@@ -0,0 +1,210 @@
+#include "ddc.h"
+
+/*
+ * Set the NCO to freq (Hz) for input sampled at fs and clear the filters.
+ */
+void ddc_init(ddc_state *d, float freq, float fs)
+{
+  d->step = (uint32_t) (freq / fs * 4294967296.0f);
+  ddc_reset(d);
+}
+
+/*
+ * Clear the filters and the NCO phase, call between bursts that are not
+ * contiguous. The first DDC_DELAY outputs after this are still filling.
+ */
+void ddc_reset(ddc_state *d)
+{
+  d->phase = 0;
+  for (uint32_t c = 0; c < 2; c++) {
+    for (uint32_t s = 0; s < DDC_CIC_ORDER; s++) {
+      d->integ[c][s] = 0;
+      d->comb[c][s] = 0;
+    }
+  }
+  d->cic_count = 0;
+#ifdef ARM_MATH_CM7
+  // clears the FIR state, the taps are symmetric so their order is moot
+  for (uint32_t c = 0; c < 2; c++) {
+    arm_fir_decimate_init_q15(&d->fir[c], DDC_FIR_TAPS, DDC_FIR_R, (q15_t *) ddc_fir_q15, d->fir_state[c],
+                              DDC_STAGE);
+  }
+  d->staged = 0;
+#else
+  for (uint32_t c = 0; c < 2; c++) {
+    for (uint32_t k = 0; k < 2 * DDC_FIR_TAPS; k++) {
+      d->delay[c][k] = 0;
+    }
+  }
+  d->fir_count = 0;
+  d->head = 0;
+#endif
+}
+
+/*
+ * Mix n samples to baseband and run them through the CIC integrators.
+ *
+ * The products are scaled to 15 bits so the integrators, which wrap, never
+ * see a final value past 31 bits. Written out for DDC_CIC_ORDER 3.
+ */
+static void ddc_mix(ddc_state *d, const int16_t *in, uint32_t n, int16_t dc)
+{
+  uint32_t phase = d->phase;
+  const uint32_t step = d->step;
+
+  uint32_t i1 = d->integ[0][0], i2 = d->integ[0][1], i3 = d->integ[0][2];
+  uint32_t q1 = d->integ[1][0], q2 = d->integ[1][1], q3 = d->integ[1][2];
+
+  for (uint32_t k = 0; k < n; k++) {
+    int32_t x = in[k] - dc;
+    uint32_t idx = phase >> (32 - DDC_NCO_BITS);
+    phase += step;
+
+    // x * exp(-j phase)
+    int32_t mi = (x * ddc_nco_q15[idx + DDC_NCO_LEN / 4]) >> 12;
+    int32_t mq = -((x * ddc_nco_q15[idx]) >> 12);
+
+    i1 += (uint32_t) mi;
+    i2 += i1;
+    i3 += i2;
+    q1 += (uint32_t) mq;
+    q2 += q1;
+    q3 += q2;
+  }
+
+  d->phase = phase;
+  d->integ[0][0] = i1; d->integ[0][1] = i2; d->integ[0][2] = i3;
+  d->integ[1][0] = q1; d->integ[1][1] = q2; d->integ[1][2] = q3;
+}
+
+/*
+ * CIC comb stages for one channel, the last integrator in, 16 bits out.
+ */
+static int16_t ddc_comb(uint32_t v, uint32_t *comb)
+{
+  for (uint32_t s = 0; s < DDC_CIC_ORDER; s++) {
+    uint32_t t = v;
+    v -= comb[s];
+    comb[s] = t;
+  }
+  return (int16_t) ((int32_t) v >> DDC_CIC_SHIFT);
+}
+
+#ifdef ARM_MATH_CM7
+
+/*
+ * Filter the staged CIC outputs that make whole FIR outputs, the rest wait
+ * for the next call. Returns the number of outputs written.
+ */
+static uint32_t ddc_fir_flush(ddc_state *d, ddc_iq *out)
+{
+  q15_t y[2][DDC_STAGE / DDC_FIR_R];
+  uint32_t m = d->staged - d->staged % DDC_FIR_R;
+  if (m == 0) {
+    return 0;
+  }
+
+  for (uint32_t c = 0; c < 2; c++) {
+    arm_fir_decimate_q15(&d->fir[c], d->stage[c], y[c], m);
+    for (uint32_t k = m; k < d->staged; k++) {
+      d->stage[c][k - m] = d->stage[c][k];
+    }
+  }
+  for (uint32_t k = 0; k < m / DDC_FIR_R; k++) {
+    out[k].i = y[0][k];
+    out[k].q = y[1][k];
+  }
+  d->staged -= m;
+  return m / DDC_FIR_R;
+}
+
+#else
+
+/*
+ * FIR output for one channel from the last DDC_FIR_TAPS CIC outputs.
+ */
+static int16_t ddc_fir(const int16_t *line)
+{
+  int32_t acc = 1 << 14;
+
+  // line holds the oldest first, tap 0 goes with the newest
+  for (uint32_t k = 0; k < DDC_FIR_TAPS; k++) {
+    acc += ddc_fir_q15[DDC_FIR_TAPS - 1 - k] * line[k];
+  }
+  acc >>= 15;
+
+  if (acc > INT16_MAX) acc = INT16_MAX;
+  if (acc < INT16_MIN) acc = INT16_MIN;
+  return (int16_t) acc;
+}
+
+#endif
+
+/*
+ * Downconvert n samples, out gets one I/Q pair per DDC_DECIM inputs. The
+ * state carries over, so a stream may be fed in blocks of any length.
+ *
+ * Returns the number of outputs written.
+ */
+uint32_t ddc_process(ddc_state *d, const int16_t *in, uint32_t n, int16_t dc, ddc_iq *out)
+{
+  uint32_t nout = 0;
+
+  while (n > 0) {
+    // run up to the next CIC output
+    uint32_t m = DDC_CIC_R - d->cic_count;
+    if (m > n) {
+      m = n;
+    }
+    ddc_mix(d, in, m, dc);
+    in += m;
+    n -= m;
+    d->cic_count += m;
+    if (d->cic_count < DDC_CIC_R) {
+      break;
+    }
+    d->cic_count = 0;
+
+#ifdef ARM_MATH_CM7
+    for (uint32_t c = 0; c < 2; c++) {
+      d->stage[c][d->staged] = ddc_comb(d->integ[c][DDC_CIC_ORDER - 1], d->comb[c]);
+    }
+    if (++d->staged == DDC_STAGE) {
+      nout += ddc_fir_flush(d, &out[nout]);
+    }
+#else
+    // the delay line is written twice so the taps never wrap
+    uint32_t h = d->head;
+    for (uint32_t c = 0; c < 2; c++) {
+      int16_t v = ddc_comb(d->integ[c][DDC_CIC_ORDER - 1], d->comb[c]);
+      d->delay[c][h] = v;
+      d->delay[c][h + DDC_FIR_TAPS] = v;
+    }
+    d->head = (h + 1) % DDC_FIR_TAPS;
+
+    if (++d->fir_count == DDC_FIR_R) {
+      d->fir_count = 0;
+      out[nout].i = ddc_fir(&d->delay[0][d->head]);
+      out[nout].q = ddc_fir(&d->delay[1][d->head]);
+      nout++;
+    }
+#endif
+  }
+
+#ifdef ARM_MATH_CM7
+  nout += ddc_fir_flush(d, &out[nout]);
+#endif
+  return nout;
+}
+
+/*
+ * Mean power of n outputs, in the same units as DDC_GAIN^2 * A^2.
+ */
+float ddc_power(const ddc_iq *z, uint32_t n)
+{
+  float sum = 0;
+  for (uint32_t k = 0; k < n; k++) {
+    sum += (float) z[k].i * z[k].i + (float) z[k].q * z[k].q;
+  }
+  return n > 0 ? sum / n : 0.0f;
+}
@@ -1,40 +1,675 @@
-#include "main.h"
 #include "dsp.h"
-#include <arm_math.h>
+#include "globals.h"
+#include <math.h>
+#include <string.h>
 
 // https://github.com/Harvie/Programs/blob/master/c/goertzel/goertzel.c
+
 /*
-* Calculate the power at 457 kHz of input buffer.
-*
-* Input buffer should be size defined by BUF_SIZE.
-*/
-float goertzel_power_457k(int16_t *data)
+ * Build a plan for the bin nearest to target_freq.
+ */
+void goertzel_plan_init(goertzel_plan *plan, float target_freq, float sampling_rate, uint32_t n)
+{
+  int32_t k = (int32_t) (0.5f + ((((float) n) * target_freq) / sampling_rate));
+  goertzel_plan_init_bin(plan, k, n);
+}
+
+/*
+ * Build a plan for bin k of an n point block.
+ */
+void goertzel_plan_init_bin(goertzel_plan *plan, int32_t k, uint32_t n)
+{
+  goertzel_plan_init_frac(plan, (float) k, n);
+}
+
+/*
+ * Build a plan between bins, k may be fractional. Only the magnitude of the
+ * result matches the DFT, the phase is still comparable between channels.
+ */
+void goertzel_plan_init_frac(goertzel_plan *plan, float k, uint32_t n)
+{
+  const float omega = (2.0f * 3.14159265f * k) / ((float) n);
+
+  plan->n = n;
+  plan->k = (int32_t) lrintf(k);
+  plan->cosine = cosf(omega);
+  plan->sine = sinf(omega);
+  plan->coeff = 2 * plan->cosine;
+  plan->scale = ((float) n) / 2.0f;
+  plan->coeff_q29 = (int32_t) lrintf(plan->coeff * (float) (1 << 29));
+}
+
+void dsp_dc_init(dsp_dc_tracker *t, float dc, float alpha)
+{
+  t->dc = dc;
+  t->alpha = alpha;
+  t->init = false;
+}
+
+/*
+ * Take in the mean of a burst windowed with the last estimate. A clipped
+ * burst's mean is pulled towards the rail, so it is left out.
+ */
+void dsp_dc_update(dsp_dc_tracker *t, const dsp_clip_stats *st, uint32_t n)
+{
+  if (n == 0 || dsp_saturated(st)) {
+    return;
+  }
+
+  float mean = (float) st->sum / n;
+  if (!t->init) {
+    t->dc = mean;
+    t->init = true;
+  }
+  else {
+    t->dc += t->alpha * (mean - t->dc);
+  }
+}
+
+/*
+ * Subtract the dc operating point and apply a Q15 window in place.
+ *
+ * Results are shifted right by 12 so a 12 bit sample stays in 16 bit range.
+ */
+void dsp_window_q15(int16_t *buf, const int16_t *window, uint32_t n, int16_t dc)
+{
+  for (uint32_t i = 0; i < n; i+=2) {
+    int32_t intres0 = (buf[i] - dc) * window[i];
+    int32_t intres1 = (buf[i+1] - dc) * window[i+1];
+
+    // shift back into 16 bit range
+    buf[i] = intres0 >> 12;
+    buf[i+1] = intres1 >> 12;
+  }
+}
+
+#if defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32
+
+/*
+ * Packed 16 bit helpers. SSUB16 sets the GE flags per halfword and SEL picks
+ * on them, both in one asm block so nothing can be scheduled in between.
+ */
+static inline uint32_t dsp_max16x2(uint32_t a, uint32_t b)
+{
+  uint32_t r;
+  __asm__ ("ssub16 %0, %1, %2\n\tsel %0, %1, %2" : "=&r" (r) : "r" (a), "r" (b) : "cc");
+  return r;
+}
+
+static inline uint32_t dsp_min16x2(uint32_t a, uint32_t b)
+{
+  uint32_t r;
+  __asm__ ("ssub16 %0, %1, %2\n\tsel %0, %2, %1" : "=&r" (r) : "r" (a), "r" (b) : "cc");
+  return r;
+}
+
+// acc plus both halfwords, signed
+static inline int32_t dsp_sum16x2(int32_t acc, uint32_t x)
+{
+  int32_t r;
+  __asm__ ("smlad %0, %1, %2, %3" : "=r" (r) : "r" (x), "r" (0x00010001u), "r" (acc));
+  return r;
+}
+
+// 1 in each halfword where a >= b
+static inline uint32_t dsp_ge16x2(uint32_t a, uint32_t b)
+{
+  uint32_t r;
+  __asm__ ("ssub16 %0, %1, %2\n\tsel %0, %3, %4"
+           : "=&r" (r) : "r" (a), "r" (b), "r" (0x00010001u), "r" (0u) : "cc");
+  return r;
+}
+
+/*
+ * Raw statistics of a block taken two samples at a time, min/max and clip
+ * compares on both halfwords of a word at once. The halves are folded
+ * together at the end.
+ */
+typedef struct
+{
+  uint32_t vmin;
+  uint32_t vmax;
+  uint32_t vcnt;      // clip count per halfword
+  int32_t sum;
+} dsp_stats_acc;
+
+static inline void dsp_stats_init(dsp_stats_acc *a)
+{
+  a->vmin = 0x7fff7fffu;
+  a->vmax = 0x80008000u;
+  a->vcnt = 0;
+  a->sum = 0;
+}
+
+static inline void dsp_stats_pair(dsp_stats_acc *a, const int16_t *p)
+{
+  const uint32_t vlo = DSP_CLIP_LO * 0x00010001u;
+  const uint32_t vhi = DSP_CLIP_HI * 0x00010001u;
+  uint32_t x;
+  memcpy(&x, p, sizeof(x));
+
+  a->vmin = dsp_min16x2(x, a->vmin);
+  a->vmax = dsp_max16x2(x, a->vmax);
+  a->vcnt += dsp_ge16x2(x, vhi) + dsp_ge16x2(vlo, x);
+  a->sum = dsp_sum16x2(a->sum, x);
+}
+
+// an odd last sample, in both halves for min/max
+static inline void dsp_stats_one(dsp_stats_acc *a, int16_t r)
+{
+  uint32_t x = (uint16_t) r * 0x00010001u;
+
+  a->vmin = dsp_min16x2(x, a->vmin);
+  a->vmax = dsp_max16x2(x, a->vmax);
+  a->vcnt += (r <= DSP_CLIP_LO) + (r >= DSP_CLIP_HI);
+  a->sum += r;
+}
+
+static inline void dsp_stats_done(const dsp_stats_acc *a, dsp_clip_stats *st)
+{
+  int16_t min0 = (int16_t) a->vmin, min1 = (int16_t) (a->vmin >> 16);
+  int16_t max0 = (int16_t) a->vmax, max1 = (int16_t) (a->vmax >> 16);
+  st->min = min0 < min1 ? min0 : min1;
+  st->max = max0 > max1 ? max0 : max1;
+  st->clipped = (a->vcnt & 0xffff) + (a->vcnt >> 16);
+  st->sum = a->sum;
+}
+
+#else
+
+/*
+ * Raw statistics of a block taken two samples at a time.
+ */
+typedef struct
+{
+  int16_t vmin;
+  int16_t vmax;
+  uint32_t cnt;
+  int32_t sum;
+} dsp_stats_acc;
+
+static inline void dsp_stats_init(dsp_stats_acc *a)
+{
+  a->vmin = INT16_MAX;
+  a->vmax = INT16_MIN;
+  a->cnt = 0;
+  a->sum = 0;
+}
+
+static inline void dsp_stats_one(dsp_stats_acc *a, int16_t r)
+{
+  a->vmin = r < a->vmin ? r : a->vmin;
+  a->vmax = r > a->vmax ? r : a->vmax;
+  a->cnt += (r <= DSP_CLIP_LO) + (r >= DSP_CLIP_HI);
+  a->sum += r;
+}
+
+static inline void dsp_stats_pair(dsp_stats_acc *a, const int16_t *p)
+{
+  dsp_stats_one(a, p[0]);
+  dsp_stats_one(a, p[1]);
+}
+
+static inline void dsp_stats_done(const dsp_stats_acc *a, dsp_clip_stats *st)
+{
+  st->min = a->vmin;
+  st->max = a->vmax;
+  st->clipped = a->cnt;
+  st->sum = a->sum;
+}
+
+#endif
+
+/*
+ * Window a block and gather its raw statistics, two samples per step.
+ */
+void dsp_window_q15_stats(int16_t *buf, const int16_t *window, uint32_t n, int16_t dc, dsp_clip_stats *st)
+{
+  dsp_stats_acc acc;
+  dsp_stats_init(&acc);
+
+  for (uint32_t i = 0; i < n; i+=2) {
+    dsp_stats_pair(&acc, &buf[i]);
+
+    int32_t intres0 = (buf[i] - dc) * window[i];
+    int32_t intres1 = (buf[i+1] - dc) * window[i+1];
+    buf[i] = intres0 >> 12;
+    buf[i+1] = intres1 >> 12;
+  }
+
+  dsp_stats_done(&acc, st);
+}
+
+/*
+ * Convert the final two Goertzel states into the normalised bin value.
+ */
+static inline dsp_complex goertzel_finish_bin(const goertzel_plan *plan, float q1, float q2)
+{
+  dsp_complex z;
+  z.re = (q1 * plan->cosine - q2) / plan->scale;
+  z.im = (q1 * plan->sine) / plan->scale;
+
+  return z;
+}
+
+/*
+ * Convert the final two Goertzel states into normalised power.
+ */
+static inline float goertzel_finish(const goertzel_plan *plan, float q1, float q2)
+{
+  return dsp_power(goertzel_finish_bin(plan, q1, q2));
+}
+
+/*
+ * Complex value of a single bin, float recurrence.
+ */
+dsp_complex goertzel_bin_f32(const goertzel_plan *plan, const int16_t *data)
+{
+  const float coeff = plan->coeff;
+
+  float q0 = 0;
+  float q1 = 0;
+  float q2 = 0;
+
+  for (uint32_t i = 0; i < plan->n; i++) {
+    q0 = ((float) data[i]) + coeff * q1 - q2;
+
+    // rotate data
+    q2 = q1;
+    q1 = q0;
+  }
+
+  return goertzel_finish_bin(plan, q1, q2);
+}
+
+/*
+ * Complex value of the same bin of two channels' blocks, X and Y, in one
+ * loop. The two recurrences are independent, so their multiply-adds
+ * interleave and each hides the other's FPU latency, where one channel at a
+ * time waits on its own chain every sample.
+ */
+void goertzel_bin_dual(const goertzel_plan *plan, const int16_t *x, const int16_t *y, dsp_complex *zx,
+                       dsp_complex *zy)
+{
+  const float coeff = plan->coeff;
+
+  float qx1 = 0;
+  float qx2 = 0;
+  float qy1 = 0;
+  float qy2 = 0;
+
+  for (uint32_t i = 0; i < plan->n; i++) {
+    float qx0 = ((float) x[i]) + coeff * qx1 - qx2;
+    float qy0 = ((float) y[i]) + coeff * qy1 - qy2;
+
+    // rotate data
+    qx2 = qx1;
+    qx1 = qx0;
+    qy2 = qy1;
+    qy1 = qy0;
+  }
+
+  *zx = goertzel_finish_bin(plan, qx1, qx2);
+  *zy = goertzel_finish_bin(plan, qy1, qy2);
+}
+
+/*
+ * Power of the same bin of two channels' blocks, see goertzel_bin_dual().
+ */
+void goertzel_power_dual(const goertzel_plan *plan, const int16_t *x, const int16_t *y, float *px, float *py)
+{
+  dsp_complex zx;
+  dsp_complex zy;
+  goertzel_bin_dual(plan, x, y, &zx, &zy);
+  *px = dsp_power(zx);
+  *py = dsp_power(zy);
+}
+
+/*
+ * Power of a single bin, float recurrence.
+ */
+float goertzel_power_f32(const goertzel_plan *plan, const int16_t *data)
+{
+  return dsp_power(goertzel_bin_f32(plan, data));
+}
+
+/*
+ * Power of a single bin, integer recurrence with a Q29 coefficient.
+ *
+ * Input must be windowed 16 bit data; the state stays well inside 32 bits
+ * for blocks up to a few thousand samples.
+ */
+float goertzel_power_q31(const goertzel_plan *plan, const int16_t *data)
 {
-  const float scaling_factor = ((float) BUF_SIZE) / 2.0;
-  const float target_freq = 457000.0;
-  // const float sampling_rate = 1800000.0;
-  const float sampling_rate = 3600000.0;
-  const int32_t k = (int32_t) (0.5 + ((((float) BUF_SIZE) * target_freq) / sampling_rate));
-  const float omega = (2.0 * 3.1415926 * k) / ((float) BUF_SIZE);
+  const int64_t coeff = plan->coeff_q29;
+
+  int32_t q0 = 0;
+  int32_t q1 = 0;
+  int32_t q2 = 0;
+
+  for (uint32_t i = 0; i < plan->n; i++) {
+    q0 = data[i] + (int32_t) ((coeff * q1) >> 29) - q2;
 
-  const float sine = arm_cos_f32(omega); 
-  const float cosine = arm_cos_f32(omega);
-  const float coeff = 2 * cosine;
+    // rotate data
+    q2 = q1;
+    q1 = q0;
+  }
+
+  return goertzel_finish(plan, (float) q1, (float) q2);
+}
+
+/*
+ * Window and Goertzel in one pass over raw samples.
+ *
+ * Gives the same result as dsp_window_q15() followed by goertzel_power_f32()
+ * but leaves the input untouched and saves a pass over memory.
+ */
+float goertzel_power_fused(const goertzel_plan *plan, const int16_t *data, const int16_t *window, int16_t dc)
+{
+  const float coeff = plan->coeff;
 
   float q0 = 0;
-  float q1 = 0; 
-  float q2 = 0; 
+  float q1 = 0;
+  float q2 = 0;
+
+  for (uint32_t i = 0; i < plan->n; i++) {
+    int32_t x = ((data[i] - dc) * window[i]) >> 12;
+    q0 = ((float) x) + coeff * q1 - q2;
 
-  for (int i = 0; i < BUF_SIZE; i++) {
-    q0 = ((float) data[i]) + coeff * q1 - q2; 
-    
     // rotate data
-    q2 = q1; 
+    q2 = q1;
     q1 = q0;
   }
 
-  float real = (q1 * cosine - q2) / scaling_factor; 
-  float imag = (q1 * sine) / scaling_factor;
+  return goertzel_finish(plan, q1, q2);
+}
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+
+// saturating 32 bit add and subtract, one QADD / QSUB each
+static inline int32_t dsp_qadd(int32_t a, int32_t b)
+{
+  int32_t r;
+  __asm__ ("qadd %0, %1, %2" : "=r" (r) : "r" (a), "r" (b));
+  return r;
+}
+
+static inline int32_t dsp_qsub(int32_t a, int32_t b)
+{
+  int32_t r;
+  __asm__ ("qsub %0, %1, %2" : "=r" (r) : "r" (a), "r" (b));
+  return r;
+}
+
+#else
+
+static inline int32_t dsp_sat32(int64_t x)
+{
+  return x > INT32_MAX ? INT32_MAX : x < INT32_MIN ? INT32_MIN : (int32_t) x;
+}
+
+static inline int32_t dsp_qadd(int32_t a, int32_t b)
+{
+  return dsp_sat32((int64_t) a + b);
+}
+
+static inline int32_t dsp_qsub(int32_t a, int32_t b)
+{
+  return dsp_sat32((int64_t) a - b);
+}
+
+#endif
+
+/*
+ * Window and Goertzel in one pass, all fixed point, for the complex bin.
+ *
+ * Q formats, with h the headroom shift:
+ *
+ *   sample - dc       Q0, signed 12 bit
+ *   window            Q15
+ *   windowed sample   Q(15-h) in int32, the product is exact before the shift
+ *   coefficient       Q29, 2 cos(omega)
+ *   state             Q(15-h) in int32, coeff * q1 in a 64 bit product >> 29
+ *
+ * The state sums and differences saturate, so a shift too small for the block
+ * clips the bin instead of wrapping it. The state is bounded by
+ * sum|x| / sin(omega), for a full scale block of n samples 2^(26-h) n /
+ * sin(omega), which DSP_Q31_HEADROOM keeps inside 31 bits.
+ *
+ * The result is in the units of the >> 12 windowed data, so it compares
+ * directly with goertzel_power_fused(), without its truncation: weak signals
+ * keep 12 - h more bits.
+ */
+dsp_complex goertzel_bin_fused_q31(const goertzel_plan *plan, const int16_t *data, const int16_t *window,
+                                   int16_t dc, uint32_t shift)
+{
+  const int64_t coeff = plan->coeff_q29;
+
+  int32_t q0 = 0;
+  int32_t q1 = 0;
+  int32_t q2 = 0;
+
+  for (uint32_t i = 0; i < plan->n; i++) {
+    int32_t x = ((data[i] - dc) * window[i]) >> shift;
+    q0 = dsp_qsub(dsp_qadd(x, (int32_t) ((coeff * q1) >> 29)), q2);
+
+    // rotate data
+    q2 = q1;
+    q1 = q0;
+  }
+
+  // back to the >> 12 scale
+  const float unit = ldexpf(1.0f, (int32_t) shift - 12);
+  return goertzel_finish_bin(plan, q1 * unit, q2 * unit);
+}
+
+/*
+ * Power of a single bin, fixed point window and Goertzel in one pass.
+ */
+float goertzel_power_fused_q31(const goertzel_plan *plan, const int16_t *data, const int16_t *window, int16_t dc,
+                               uint32_t shift)
+{
+  return dsp_power(goertzel_bin_fused_q31(plan, data, window, dc, shift));
+}
+
+/*
+ * Power of up to DSP_MAX_BINS bins from a single pass over the data.
+ *
+ * All plans must share the same block length.
+ */
+void goertzel_power_multibin(const goertzel_plan *plans, uint32_t nbins, const int16_t *data, float *power)
+{
+  float coeff[DSP_MAX_BINS];
+  float q1[DSP_MAX_BINS] = {0};
+  float q2[DSP_MAX_BINS] = {0};
+
+  if (nbins > DSP_MAX_BINS) {
+    nbins = DSP_MAX_BINS;
+  }
+
+  for (uint32_t b = 0; b < nbins; b++) {
+    coeff[b] = plans[b].coeff;
+  }
+
+  for (uint32_t i = 0; i < plans[0].n; i++) {
+    float x = (float) data[i];
+    for (uint32_t b = 0; b < nbins; b++) {
+      float q0 = x + coeff[b] * q1[b] - q2[b];
+      q2[b] = q1[b];
+      q1[b] = q0;
+    }
+  }
+
+  for (uint32_t b = 0; b < nbins; b++) {
+    power[b] = goertzel_finish(&plans[b], q1[b], q2[b]);
+  }
+}
+
+/*
+ * Complex value of up to DSP_MAX_BINS bins from a single pass over the data.
+ *
+ * All plans must share the same block length.
+ */
+void goertzel_bin_multibin(const goertzel_plan *plans, uint32_t nbins, const int16_t *data, dsp_complex *bins)
+{
+  float coeff[DSP_MAX_BINS];
+  float q1[DSP_MAX_BINS] = {0};
+  float q2[DSP_MAX_BINS] = {0};
+
+  if (nbins > DSP_MAX_BINS) {
+    nbins = DSP_MAX_BINS;
+  }
+
+  for (uint32_t b = 0; b < nbins; b++) {
+    coeff[b] = plans[b].coeff;
+  }
+
+  for (uint32_t i = 0; i < plans[0].n; i++) {
+    float x = (float) data[i];
+    for (uint32_t b = 0; b < nbins; b++) {
+      float q0 = x + coeff[b] * q1[b] - q2[b];
+      q2[b] = q1[b];
+      q1[b] = q0;
+    }
+  }
+
+  for (uint32_t b = 0; b < nbins; b++) {
+    bins[b] = goertzel_finish_bin(&plans[b], q1[b], q2[b]);
+  }
+}
+
+/*
+ * Complex value of up to DSP_MAX_BINS bins straight from raw samples, no
+ * window, with the raw statistics gathered in the same pass.
+ *
+ * For a tone centred on a bin of the block the rectangular window loses
+ * nothing and puts exact nulls on the other bins, so the windowing pass and
+ * its table can be skipped. The bins are scaled by gain, e.g. the coherent
+ * gain of the window this stands in for so the powers read the same.
+ */
+void goertzel_bin_multibin_raw(const goertzel_plan *plans, uint32_t nbins, const int16_t *data, int16_t dc,
+                               float gain, dsp_clip_stats *st, dsp_complex *bins)
+{
+  float coeff[DSP_MAX_BINS];
+  float q1[DSP_MAX_BINS] = {0};
+  float q2[DSP_MAX_BINS] = {0};
+  const uint32_t n = plans[0].n;
+  dsp_stats_acc acc;
+  dsp_stats_init(&acc);
+
+  if (nbins > DSP_MAX_BINS) {
+    nbins = DSP_MAX_BINS;
+  }
+
+  for (uint32_t b = 0; b < nbins; b++) {
+    coeff[b] = plans[b].coeff;
+  }
+
+  // statistics two samples at a time, the recurrence runs on each
+  for (uint32_t i = 0; i < n; i += 2) {
+    uint32_t m = n - i < 2 ? 1 : 2;
+    if (m == 2) {
+      dsp_stats_pair(&acc, &data[i]);
+    }
+    else {
+      dsp_stats_one(&acc, data[i]);
+    }
+
+    for (uint32_t j = 0; j < m; j++) {
+      float x = (float) (data[i + j] - dc);
+      for (uint32_t b = 0; b < nbins; b++) {
+        float q0 = x + coeff[b] * q1[b] - q2[b];
+        q2[b] = q1[b];
+        q1[b] = q0;
+      }
+    }
+  }
+
+  for (uint32_t b = 0; b < nbins; b++) {
+    bins[b] = goertzel_finish_bin(&plans[b], gain * q1[b], gain * q2[b]);
+  }
+  dsp_stats_done(&acc, st);
+}
+
+/*
+ * Complex value of up to DSP_MAX_BINS bins of a raw block, windowed and run
+ * through the fixed point recurrence in one pass, with the raw statistics
+ * gathered alongside. The windowed samples keep their low bits, see
+ * goertzel_bin_fused_q31(), and the block is left as it was.
+ *
+ * All plans must share the same block length.
+ */
+void goertzel_bin_multibin_fused_q31(const goertzel_plan *plans, uint32_t nbins, const int16_t *data,
+                                     const int16_t *window, int16_t dc, uint32_t shift, dsp_clip_stats *st,
+                                     dsp_complex *bins)
+{
+  int64_t coeff[DSP_MAX_BINS];
+  int32_t q1[DSP_MAX_BINS] = {0};
+  int32_t q2[DSP_MAX_BINS] = {0};
+  const uint32_t n = plans[0].n;
+  dsp_stats_acc acc;
+  dsp_stats_init(&acc);
+
+  if (nbins > DSP_MAX_BINS) {
+    nbins = DSP_MAX_BINS;
+  }
+
+  for (uint32_t b = 0; b < nbins; b++) {
+    coeff[b] = plans[b].coeff_q29;
+  }
+
+  // statistics two samples at a time, the recurrence runs on each
+  for (uint32_t i = 0; i < n; i += 2) {
+    uint32_t m = n - i < 2 ? 1 : 2;
+    if (m == 2) {
+      dsp_stats_pair(&acc, &data[i]);
+    }
+    else {
+      dsp_stats_one(&acc, data[i]);
+    }
+
+    for (uint32_t j = 0; j < m; j++) {
+      int32_t x = ((data[i + j] - dc) * window[i + j]) >> shift;
+      for (uint32_t b = 0; b < nbins; b++) {
+        int32_t q0 = dsp_qsub(dsp_qadd(x, (int32_t) ((coeff[b] * q1[b]) >> 29)), q2[b]);
+        q2[b] = q1[b];
+        q1[b] = q0;
+      }
+    }
+  }
+
+  // back to the >> 12 scale
+  const float unit = ldexpf(1.0f, (int32_t) shift - 12);
+  for (uint32_t b = 0; b < nbins; b++) {
+    bins[b] = goertzel_finish_bin(&plans[b], q1[b] * unit, q2[b] * unit);
+  }
+  dsp_stats_done(&acc, st);
+}
+
+/*
+* Calculate the power at 457 kHz of input buffer.
+*
+* Input buffer should be size defined by BUF_SIZE. When undersampling the
+* bin is at the carrier's alias, ACQ_IF_HZ.
+*/
+float goertzel_power_457k(int16_t *data)
+{
+  return dsp_power(goertzel_bin_457k(data));
+}
+
+/*
+* Complex value of the 457 kHz bin of input buffer.
+*
+* Input buffer should be size defined by BUF_SIZE.
+*/
+dsp_complex goertzel_bin_457k(int16_t *data)
+{
+  static goertzel_plan plan;
+
+  // plan is built on first use
+  if (plan.n == 0) {
+    goertzel_plan_init(&plan, ACQ_IF_HZ, ACQ_FS_HZ, BUF_SIZE);
+  }
 
-  return real*real + imag*imag;
+  return goertzel_bin_f32(&plan, data);
 }
@@ -0,0 +1,157 @@
+#include "freq.h"
+#include <math.h>
+
+/*
+ * Build the three plans around a frequency.
+ */
+static void freq_tune(freq_tracker *ft, float span, float hz)
+{
+  float k = hz * ft->n / ft->fs;
+
+  goertzel_plan_init_frac(&ft->plans[0], k - span, ft->n);
+  goertzel_plan_init_frac(&ft->plans[FREQ_CENTRE], k, ft->n);
+  goertzel_plan_init_frac(&ft->plans[2], k + span, ft->n);
+  ft->tuned_hz = hz;
+}
+
+/*
+ * Start on the nominal frequency. Plans are for blocks of n samples at fs.
+ */
+void freq_init(freq_tracker *ft, const freq_params *p, float nominal_hz, float fs, uint32_t n)
+{
+  ft->nominal_hz = nominal_hz;
+  ft->fs = fs;
+  ft->n = n;
+  ft->offset_hz = 0;
+  ft->pulses = 0;
+  ft->retunes = 0;
+  ft->bursts = 0;
+  for (uint32_t b = 0; b < FREQ_BINS; b++) {
+    ft->acc[b] = 0;
+  }
+  freq_tune(ft, p->span, nominal_hz);
+
+  // start windowed, the beacon may be anywhere in the search range
+  float k = nominal_hz * n / fs;
+  ft->rect_ok = p->rect_max_bins > 0 && fabsf(k - roundf(k)) < FREQ_RECT_CENTRED;
+  ft->rect = false;
+}
+
+/*
+ * Add the power of the three bins for one burst inside a pulse, summed over
+ * both channels.
+ */
+void freq_push(freq_tracker *ft, const float *power)
+{
+  for (uint32_t b = 0; b < FREQ_BINS; b++) {
+    ft->acc[b] += power[b];
+  }
+  ft->bursts++;
+}
+
+/*
+ * Peak position from three equally spaced powers, in units of their spacing.
+ * The centre need not be the largest as long as the logs bend down, else 0.
+ */
+float freq_interp(float pm, float p0, float pp)
+{
+  if (!(pm > 0 && p0 > 0 && pp > 0)) {
+    return 0;
+  }
+
+  // log power is twice log magnitude, the ratio is the same
+  float lm = logf(pm);
+  float l0 = logf(p0);
+  float lp = logf(pp);
+  float curve = 2 * l0 - lm - lp;
+  if (!(curve > 0)) {
+    return 0;
+  }
+  return 0.5f * (lp - lm) / curve;
+}
+
+/*
+ * Offset in bins of a tone from the centre plan, unwindowed bursts with the
+ * side plans span bins out (a whole number, on the nulls). Each side bin
+ * gives d from its ratio to the centre, the larger side sets the sign.
+ */
+float freq_rect_offset(float pm, float p0, float pp, float span)
+{
+  if (!(p0 > 0)) {
+    return 0;
+  }
+
+  // |z(+span)| / |z(0)| = d / (span - d) for a tone d above, and mirrored
+  float a = sqrtf(fmaxf(pm, pp) / p0);
+  float d = span * a / (1 + a);
+  return pp >= pm ? d : -d;
+}
+
+/*
+ * Estimate the offset from the pulse just collected and retune when due.
+ * Returns true if the plans or the window changed.
+ */
+bool freq_pulse_end(freq_tracker *ft, const freq_params *p)
+{
+  if (ft->bursts == 0) {
+    return false;
+  }
+
+  // offset of this pulse from the plans in bins, straight from the leakage
+  // without the window
+  float step;
+  if (ft->rect) {
+    step = freq_rect_offset(ft->acc[0], ft->acc[FREQ_CENTRE], ft->acc[2], p->span);
+  }
+  else {
+    step = p->span * freq_interp(ft->acc[0], ft->acc[FREQ_CENTRE], ft->acc[2]) / p->slope;
+  }
+  for (uint32_t b = 0; b < FREQ_BINS; b++) {
+    ft->acc[b] = 0;
+  }
+  ft->bursts = 0;
+
+  // offset of this pulse from nominal, a step of at most a span
+  float bin_hz = ft->fs / ft->n;
+  if (step > p->span) step = p->span;
+  if (step < -p->span) step = -p->span;
+  float est = ft->tuned_hz - ft->nominal_hz + step * bin_hz;
+
+  ft->offset_hz += p->alpha * (est - ft->offset_hz);
+  if (ft->offset_hz > p->max_offset_hz) ft->offset_hz = p->max_offset_hz;
+  if (ft->offset_hz < -p->max_offset_hz) ft->offset_hz = -p->max_offset_hz;
+
+  // no window while the tone stays near the bin centre, back to the flattop
+  // as soon as one pulse is further off. Plans stay on the bin meanwhile
+  if (ft->rect) {
+    if (fabsf(step) > p->rect_max_bins) {
+      ft->rect = false;
+      ft->pulses = 0;
+      return true;
+    }
+    return false;
+  }
+
+  if (++ft->pulses < p->retune_pulses) {
+    return false;
+  }
+  ft->pulses = 0;
+
+  // settled near the bin centre, drop the window instead of retuning
+  if (ft->rect_ok && fabsf(ft->offset_hz) < 0.5f * p->rect_max_bins * bin_hz) {
+    ft->rect = true;
+    if (ft->tuned_hz != ft->nominal_hz) {
+      freq_tune(ft, p->span, ft->nominal_hz);
+      ft->retunes++;
+    }
+    return true;
+  }
+
+  float hz = freq_hz(ft);
+  if (fabsf(hz - ft->tuned_hz) < p->retune_hz) {
+    return false;
+  }
+  freq_tune(ft, p->span, hz);
+  ft->retunes++;
+  return true;
+}
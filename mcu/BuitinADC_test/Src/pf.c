@@ -0,0 +1,367 @@
+#include "pf.h"
+#include <math.h>
+#include <string.h>
+
+#define PF_PI 3.14159265f
+
+// roughening after resampling, K N^(-1/3) with K = 0.2 for 3 state variables
+#define PF_ROUGHEN (0.2f / 6.35f)
+
+/*
+ * The per particle loops below are written so the host compiler vectorises
+ * them at -O2: no calls (log, exp, cos and the noise are inlined
+ * approximations), no table lookups, no reductions mixed into the same loop,
+ * and selects done on integers or bit patterns, as the compiler will not
+ * turn a float select into a blend under the default -ftrapping-math. On the
+ * M7 the approximations are cheaper than the libm calls too.
+ */
+
+static inline uint32_t pf_bits(float f)
+{
+  uint32_t u;
+  memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+static inline float pf_float(uint32_t u)
+{
+  float f;
+  memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+/*
+ * Natural log of a positive normal float, to about 1e-7. The mantissa is
+ * taken to [sqrt(1/2), sqrt(2)) and log(m) = 2 atanh((m - 1) / (m + 1)).
+ */
+static inline float pf_log(float x)
+{
+  uint32_t u = pf_bits(x);
+  uint32_t mant = u & 0x007fffffu;
+  uint32_t hi = mant > 0x003504f3u;   // mantissa of sqrt(2)
+  int32_t e = (int32_t) (u >> 23) - 127 + (int32_t) hi;
+  float m = pf_float(mant | (0x3f800000u - (hi << 23)));
+
+  float t = (m - 1.0f) / (m + 1.0f);
+  float t2 = t * t;
+  float l = t * (2.0f + t2 * (0.666666667f + t2 * (0.4f + t2 * 0.285714286f)));
+  return l + (float) e * 0.693147181f;
+}
+
+/*
+ * e^x for x <= 0, to about 1e-7 relative. Anything below -87 comes out as
+ * 2^-126, as good as zero for a weight.
+ */
+static inline float pf_exp(float x)
+{
+  // clamped on the bit pattern, past -126 a negative float's bits only grow
+  uint32_t yb = pf_bits(x * 1.44269504f);
+  const uint32_t ylim = 0xc2fc0000u;  // -126.0f
+  float y = pf_float(yb > ylim ? ylim : yb);
+  int32_t n = (int32_t) (y - 0.5f);
+  float f = y - (float) n;
+
+  // 2^f on [-0.5, 0.5]
+  float p = 1.0f + f * (0.693147181f + f * (0.240226507f + f * (0.0555041087f + f * (0.00961812911f
+            + f * (0.00133335581f + f * 0.000154035304f)))));
+  return p * pf_float((uint32_t) (n + 127) << 23);
+}
+
+/*
+ * Dipole axis of a particle. The field only depends on the axis up to its
+ * sign, so the angle is taken mod pi to [-pi/2, pi/2) where short Taylor
+ * series do.
+ */
+static inline void pf_axis(uint16_t phi, float *c, float *s)
+{
+  float a = (float) (int16_t) (uint16_t) (phi << 1) * (PF_PI / 65536.0f);
+  float a2 = a * a;
+  *c = 1.0f + a2 * (-0.5f + a2 * (0.0416666667f + a2 * (-0.00138888889f + a2 * (2.48015873e-5f
+       + a2 * -2.75573192e-7f))));
+  *s = a * (1.0f + a2 * (-0.166666667f + a2 * (0.00833333333f + a2 * (-0.000198412698f
+       + a2 * 2.75573192e-6f))));
+}
+
+/*
+ * Uniform in [0, 1), the serial generator. Only used once per call to key
+ * the per particle noise and for the odd scalar draw.
+ */
+static float pf_uniform(pf_filter *pf)
+{
+  uint32_t r = pf->rng;
+  r ^= r << 13;
+  r ^= r >> 17;
+  r ^= r << 5;
+  pf->rng = r;
+  return (r >> 8) * (1.0f / 16777216.0f);
+}
+
+/*
+ * Roughly normal with unit variance, sum of four uniforms.
+ */
+static float pf_normal(pf_filter *pf)
+{
+  float s = pf_uniform(pf) + pf_uniform(pf) + pf_uniform(pf) + pf_uniform(pf);
+  return (s - 2.0f) * 1.7320508f;
+}
+
+/*
+ * Fresh key for the noise of one pass over the particles.
+ */
+static uint32_t pf_key(pf_filter *pf)
+{
+  pf_uniform(pf);
+  return pf->rng;
+}
+
+/*
+ * Noise number i under a key, roughly normal with unit variance: a hash of
+ * the counter (no state carried between particles) whose four bytes are
+ * summed like pf_normal() sums four uniforms.
+ */
+static inline float pf_noise(uint32_t key, uint32_t i)
+{
+  uint32_t h = key + i * 0x9e3779b9u;
+  h ^= h >> 16;
+  h *= 0x7feb352du;
+  h ^= h >> 15;
+  h *= 0x846ca68bu;
+  h ^= h >> 16;
+
+  uint32_t b = (h & 0xffu) + ((h >> 8) & 0xffu) + ((h >> 16) & 0xffu) + (h >> 24);
+  return ((float) b - 510.0f) * 0.00676597f;
+}
+
+/*
+ * Round half away from zero, the half taking the sign of x.
+ */
+static inline int32_t pf_round(float x)
+{
+  return (int32_t) (x + pf_float((pf_bits(x) & 0x80000000u) | 0x3f000000u));
+}
+
+/*
+ * Metres to Q8, clamped after rounding (positions are finite and far
+ * inside the int32 range).
+ */
+static inline int16_t pf_to_q8(float m)
+{
+  int32_t q = pf_round(m * PF_POS_Q);
+  q = q > INT16_MAX ? INT16_MAX : q;
+  q = q < INT16_MIN ? INT16_MIN : q;
+  return (int16_t) q;
+}
+
+static inline uint16_t pf_to_angle(float rad)
+{
+  return (uint16_t) pf_round(rad * (65536.0f / (2 * PF_PI)));
+}
+
+void pf_init(pf_filter *pf, uint32_t seed)
+{
+  pf->init = false;
+  pf->updates = 0;
+  pf->rng = seed ? seed : 1;
+}
+
+/*
+ * Spread the particles from the first reading. The range is drawn from the
+ * reading's amplitude, the dipole factor between broadside and on axis (1 to
+ * 2) being unknown, bearing and axis are uniform.
+ */
+static void pf_seed(pf_filter *pf, const pf_params *p, float amp)
+{
+  for (uint32_t i = 0; i < PF_NUM; i++) {
+    float r = cbrtf(p->moment * (1.0f + pf_uniform(pf)) / amp);
+    float h2 = r * r - p->depth_m * p->depth_m;
+    float h = h2 > 0 ? sqrtf(h2) : 0;
+    h *= 1.0f + 0.2f * pf_normal(pf);
+    if (h < p->range_min_m) h = p->range_min_m;
+    if (h > p->range_max_m) h = p->range_max_m;
+
+    float b = 2 * PF_PI * pf_uniform(pf);
+    pf->x[i] = pf_to_q8(h * cosf(b));
+    pf->y[i] = pf_to_q8(h * sinf(b));
+    pf->phi[i] = (uint16_t) (pf_uniform(pf) * 65536.0f);
+    pf->w[i] = 1.0f / PF_NUM;
+  }
+  pf->init = true;
+}
+
+/*
+ * Systematic resampling. The copies are roughened, jittered by a fraction
+ * of the cloud's extent, so repeated readings from nearly the same spot do
+ * not collapse the cloud onto a few particles.
+ */
+static void pf_resample(pf_filter *pf)
+{
+  float step = 1.0f / PF_NUM;
+  float u = pf_uniform(pf) * step;
+  float c = pf->w[0];
+  uint32_t j = 0;
+  int16_t xmin = INT16_MAX, xmax = INT16_MIN;
+  int16_t ymin = INT16_MAX, ymax = INT16_MIN;
+
+  for (uint32_t i = 0; i < PF_NUM; i++) {
+    float target = u + i * step;
+    while (target > c && j < PF_NUM - 1) {
+      c += pf->w[++j];
+    }
+    pf->x2[i] = pf->x[j];
+    pf->y2[i] = pf->y[j];
+    pf->phi2[i] = pf->phi[j];
+    if (pf->x[j] < xmin) xmin = pf->x[j];
+    if (pf->x[j] > xmax) xmax = pf->x[j];
+    if (pf->y[j] < ymin) ymin = pf->y[j];
+    if (pf->y[j] > ymax) ymax = pf->y[j];
+  }
+
+  float kx = PF_ROUGHEN * (xmax - xmin) / PF_POS_Q;
+  float ky = PF_ROUGHEN * (ymax - ymin) / PF_POS_Q;
+  uint32_t key = pf_key(pf);
+  for (uint32_t i = 0; i < PF_NUM; i++) {
+    pf->x[i] = pf_to_q8(pf->x2[i] / PF_POS_Q + kx * pf_noise(key, 2 * i));
+    pf->y[i] = pf_to_q8(pf->y2[i] / PF_POS_Q + ky * pf_noise(key, 2 * i + 1));
+    pf->phi[i] = pf->phi2[i];
+    pf->w[i] = step;
+  }
+}
+
+/*
+ * Weigh the particles with one reading: X and Y power and the X/Y cross term.
+ *
+ * The amplitude is compared in log, the field angle through the doubled angle
+ * so its 180 degree ambiguity drops out. The measured doubled angle is
+ * (px - py, 2 pxy) / (px + py), no square roots needed.
+ */
+void pf_update(pf_filter *pf, const pf_params *p, float px, float py, float pxy)
+{
+  float mp = px + py;
+  if (mp <= 0) {
+    return;
+  }
+  if (!pf->init) {
+    pf_seed(pf, p, sqrtf(mp));
+  }
+  pf->updates++;
+
+  float uc = (px - py) / mp;
+  float us = 2 * pxy / mp;
+  float lnm = logf(mp) - logf(p->moment * p->moment);
+  float kmag = 0.125f / (p->mag_sigma * p->mag_sigma);
+  float kang = 0.25f / (p->ang_sigma * p->ang_sigma);
+  float d2 = p->depth_m * p->depth_m + 1e-4f;
+  const float inv_q = 1.0f / PF_POS_Q;
+
+  float *ll = pf->w2;
+  for (uint32_t i = 0; i < PF_NUM; i++) {
+    // from the beacon to the searcher
+    float vx = -pf->x[i] * inv_q;
+    float vy = -pf->y[i] * inv_q;
+    float c, s;
+    pf_axis(pf->phi[i], &c, &s);
+
+    // horizontal field times r^5 / moment
+    float r2 = vx * vx + vy * vy + d2;
+    float md = c * vx + s * vy;
+    float bx = 3 * md * vx - r2 * c;
+    float by = 3 * md * vy - r2 * s;
+    float bb = bx * bx + by * by + 1e-12f;
+
+    float dl = lnm - pf_log(bb) + 5 * pf_log(r2);
+    float dot = (uc * (bx * bx - by * by) + us * 2 * bx * by) / bb;
+    ll[i] = -kmag * dl * dl - kang * (1 - dot);
+  }
+
+  float ll_max = ll[0];
+  for (uint32_t i = 1; i < PF_NUM; i++) {
+    ll_max = ll[i] > ll_max ? ll[i] : ll_max;
+  }
+
+  for (uint32_t i = 0; i < PF_NUM; i++) {
+    pf->w[i] *= pf_exp(ll[i] - ll_max);
+  }
+
+  float sum = 0;
+  for (uint32_t i = 0; i < PF_NUM; i++) {
+    sum += pf->w[i];
+  }
+
+  // every particle far off, start again from this reading
+  if (!(sum > 1e-30f)) {
+    pf_seed(pf, p, sqrtf(mp));
+    return;
+  }
+
+  float inv_sum = 1.0f / sum;
+  for (uint32_t i = 0; i < PF_NUM; i++) {
+    pf->w[i] *= inv_sum;
+  }
+
+  float sq = 0;
+  for (uint32_t i = 0; i < PF_NUM; i++) {
+    sq += pf->w[i] * pf->w[i];
+  }
+
+  // effective particle count below half
+  if (sq * PF_NUM > 2.0f) {
+    pf_resample(pf);
+  }
+}
+
+/*
+ * Move the particles by a turn (rad, + is left) followed by one step ahead.
+ */
+void pf_predict(pf_filter *pf, const pf_params *p, float turn)
+{
+  if (!pf->init) {
+    return;
+  }
+
+  float ct = cosf(turn);
+  float st = sinf(turn);
+  uint16_t dphi = pf_to_angle(turn);
+  const float inv_q = 1.0f / PF_POS_Q;
+  uint32_t key = pf_key(pf);
+
+  for (uint32_t i = 0; i < PF_NUM; i++) {
+    float x = pf->x[i] * inv_q;
+    float y = pf->y[i] * inv_q;
+    float nx = x * ct + y * st - p->step_m + p->pos_sigma_m * pf_noise(key, 3 * i);
+    float ny = y * ct - x * st + p->pos_sigma_m * pf_noise(key, 3 * i + 1);
+    pf->x[i] = pf_to_q8(nx);
+    pf->y[i] = pf_to_q8(ny);
+    pf->phi[i] = (uint16_t) (pf->phi[i] - dphi + pf_to_angle(p->turn_sigma * pf_noise(key, 3 * i + 2)));
+  }
+}
+
+/*
+ * Range is the weighted mean of the particle ranges. The dipole field is the
+ * same for a beacon ahead and the mirror one behind, so until the walk tells
+ * them apart the particles sit in two clouds and the mean position (which
+ * gives the bearing) is not trusted for range.
+ */
+pf_estimate pf_get_estimate(const pf_filter *pf)
+{
+  pf_estimate est = {0, 0, 0};
+  if (!pf->init) {
+    return est;
+  }
+
+  const float inv_q = 1.0f / PF_POS_Q;
+  float mx = 0, my = 0, mh = 0, mh2 = 0;
+  for (uint32_t i = 0; i < PF_NUM; i++) {
+    float x = pf->x[i] * inv_q;
+    float y = pf->y[i] * inv_q;
+    float h2 = x * x + y * y;
+    mx += pf->w[i] * x;
+    my += pf->w[i] * y;
+    mh += pf->w[i] * sqrtf(h2);
+    mh2 += pf->w[i] * h2;
+  }
+
+  est.range_m = mh;
+  est.bearing = atan2f(my, mx);
+  est.spread_m = sqrtf(fmaxf(mh2 - mh * mh, 0));
+  return est;
+}
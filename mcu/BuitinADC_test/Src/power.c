@@ -0,0 +1,171 @@
+#include "power.h"
+#include <math.h>
+
+/*
+ * Set up one stage, clears its history. Returns false if a boxcar was longer
+ * than SMOOTH_MAX_BOXCAR and has been cut to it.
+ */
+static bool smooth_stage_init(smooth_stage *st, const smooth_stage_cfg *cfg)
+{
+  bool ok = true;
+  st->cfg = *cfg;
+
+  if (st->cfg.len == 0) {
+    st->cfg.len = 1;
+  }
+  if (st->cfg.mode == SMOOTH_BOXCAR && st->cfg.len > SMOOTH_MAX_BOXCAR) {
+    st->cfg.len = SMOOTH_MAX_BOXCAR;
+    ok = false;
+  }
+
+  // tau <= 0 means no smoothing
+  st->alpha = st->cfg.tau > 0 ? 1.0f - expf(-1.0f / st->cfg.tau) : 1.0f;
+  st->acc = 0;
+  st->n = 0;
+  st->out = 0;
+  st->head = 0;
+  st->sum = 0;
+  return ok;
+}
+
+/*
+ * Add one input to a boxcar and return the mean of the last len inputs, of
+ * all of them until len have been seen.
+ */
+static float smooth_boxcar_push(smooth_stage *st, float x)
+{
+  const uint32_t len = st->cfg.len;
+
+  if (st->n < len) {
+    st->n++;
+  }
+  else {
+    st->sum -= st->box[st->head];
+  }
+  st->box[st->head] = x;
+  st->sum += x;
+  st->head = st->head + 1 == len ? 0 : st->head + 1;
+
+  // once per turn of the ring, sum afresh so rounding can't build up
+  if (st->head == 0) {
+    st->sum = 0;
+    for (uint32_t i = 0; i < st->n; i++) {
+      st->sum += st->box[i];
+    }
+  }
+  return st->sum / st->n;
+}
+
+/*
+ * Run one input through a stage and return its output.
+ */
+static float smooth_stage_push(smooth_stage *st, float x)
+{
+  switch (st->cfg.mode) {
+    case SMOOTH_EMA:
+      // first input seeds the average
+      if (st->n == 0) {
+        st->out = x;
+        st->n = 1;
+      }
+      else {
+        st->out += st->alpha * (x - st->out);
+      }
+    break;
+    case SMOOTH_BOXCAR:
+      st->out = smooth_boxcar_push(st, x);
+    break;
+    case SMOOTH_CIC:
+      st->acc += x;
+      st->n++;
+      if (st->n == st->cfg.len) {
+        st->out = st->acc / st->cfg.len;
+        st->acc = 0;
+        st->n = 0;
+      }
+    break;
+    case SMOOTH_NONE:
+    default:
+      st->out = x;
+    break;
+  }
+
+  return st->out;
+}
+
+/*
+ * (Re)configure a smoother. Can be called at any time, history is dropped.
+ * Returns false if a boxcar was longer than SMOOTH_MAX_BOXCAR, it then runs
+ * at that length.
+ */
+bool power_smoother_init(power_smoother *ps, const smooth_cfg *cfg)
+{
+  ps->decim = cfg->decim ? cfg->decim : 1;
+  ps->phase = 0;
+  bool ok = smooth_stage_init(&ps->burst, &cfg->burst);
+  ok &= smooth_stage_init(&ps->guide, &cfg->guide);
+  ps->burst_out = 0;
+  ps->guide_out = 0;
+  return ok;
+}
+
+/*
+ * Push one burst power. Updates burst_out every call, returns true when a new
+ * guidance rate output is in guide_out.
+ */
+bool power_smoother_push(power_smoother *ps, float power)
+{
+  ps->burst_out = smooth_stage_push(&ps->burst, power);
+
+  ps->phase++;
+  if (ps->phase < ps->decim) {
+    return false;
+  }
+  ps->phase = 0;
+
+  ps->guide_out = smooth_stage_push(&ps->guide, ps->burst_out);
+  return true;
+}
+
+/*
+ * Independent inputs averaged into one output of a stage. An EMA counts as
+ * the boxcar of equal noise, (2 - alpha) / alpha inputs.
+ */
+static uint32_t smooth_stage_span(const smooth_stage_cfg *cfg)
+{
+  uint32_t n = 1;
+
+  switch (cfg->mode) {
+    case SMOOTH_EMA:
+      if (cfg->tau > 0) {
+        float a = 1.0f - expf(-1.0f / cfg->tau);
+        n = (uint32_t) ((2.0f - a) / a);
+      }
+    break;
+    case SMOOTH_BOXCAR:
+      n = cfg->len > SMOOTH_MAX_BOXCAR ? SMOOTH_MAX_BOXCAR : cfg->len;
+    break;
+    case SMOOTH_CIC:
+      n = cfg->len;
+    break;
+    case SMOOTH_NONE:
+    default:
+    break;
+  }
+
+  return n ? n : 1;
+}
+
+/*
+ * Bursts whose noise is averaged into one guidance rate output, rounded
+ * down. Guidance stage inputs are decim bursts apart, so they share bursts
+ * when the burst stage spans more than decim.
+ */
+uint32_t power_smoother_span(const smooth_cfg *cfg)
+{
+  uint32_t decim = cfg->decim ? cfg->decim : 1;
+  uint32_t b = smooth_stage_span(&cfg->burst);
+  uint32_t g = smooth_stage_span(&cfg->guide);
+
+  return b + (g - 1) * (b < decim ? b : decim);
+}
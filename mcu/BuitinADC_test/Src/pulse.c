@@ -0,0 +1,127 @@
+#include "pulse.h"
+#include <math.h>
+
+// gain for period and on-time updates
+#define PULSE_TRACK_GAIN 0.25f
+
+// noise floor follows drops quickly so a start inside a pulse recovers
+#define PULSE_FLOOR_DOWN_GAIN 0.25f
+
+void pulse_init(pulse_detector *pd)
+{
+  pd->on = false;
+  pd->floor_valid = false;
+  pd->have_rise = false;
+  pd->locked = false;
+  pd->floor = 0;
+  pd->period = 0;
+  pd->on_time = 0;
+  pd->matches = 0;
+  pd->last_rise = 0;
+}
+
+/*
+ * Number of periods an interval between rising edges spans, 0 if it is not
+ * within tol (relative) of a whole number of periods or the period is unknown.
+ */
+uint32_t pulse_period_match(float period, uint32_t interval, float tol)
+{
+  if (period <= 0) {
+    return 0;
+  }
+
+  float n = roundf(interval / period);
+  if (n < 1 || fabsf(interval - n * period) > tol * period) {
+    return 0;
+  }
+  return (uint32_t) n;
+}
+
+/*
+ * Learn the period from the interval between two rising edges. Intervals that
+ * are a multiple of the period (missed pulses) still count.
+ */
+static void pulse_learn_period(pulse_detector *pd, const pulse_params *p, uint32_t interval)
+{
+  uint32_t n = pulse_period_match(pd->period, interval, p->period_tol);
+  if (n) {
+    pd->period += PULSE_TRACK_GAIN * ((float) interval / n - pd->period);
+    pd->matches++;
+    if (pd->matches >= p->lock_count) {
+      pd->locked = true;
+    }
+    return;
+  }
+
+  // no match, start over with this interval as the guess
+  pd->locked = false;
+  pd->matches = 0;
+  if (interval >= p->min_period_ms && interval <= p->max_period_ms) {
+    pd->period = interval;
+  }
+  else {
+    pd->period = 0;
+  }
+}
+
+/*
+ * Feed the power of one burst taken at t_ms. Returns where the burst sits in
+ * the pulse train.
+ */
+pulse_event pulse_update(pulse_detector *pd, const pulse_params *p, uint32_t t_ms, float power)
+{
+  if (!pd->floor_valid) {
+    pd->floor = power;
+    pd->floor_valid = true;
+    return PULSE_OFF;
+  }
+
+  if (pd->on) {
+    if (power < pd->floor * p->off_ratio) {
+      float len = (float) (t_ms - pd->last_rise);
+      pd->on_time = pd->on_time > 0 ? pd->on_time + PULSE_TRACK_GAIN * (len - pd->on_time) : len;
+      pd->on = false;
+      return PULSE_FALL;
+    }
+    return PULSE_ON;
+  }
+
+  if (power > pd->floor * p->on_ratio) {
+    if (pd->have_rise) {
+      pulse_learn_period(pd, p, t_ms - pd->last_rise);
+    }
+    pd->last_rise = t_ms;
+    pd->have_rise = true;
+    pd->on = true;
+    return PULSE_RISE;
+  }
+
+  // only off-pulse bursts move the floor
+  float gain = power < pd->floor ? PULSE_FLOOR_DOWN_GAIN : p->floor_alpha;
+  pd->floor += gain * (power - pd->floor);
+  return PULSE_OFF;
+}
+
+/*
+ * True if a burst at t_ms may hold a pulse and should be processed. Always
+ * true until the period is locked. Drops the lock after miss_count periods
+ * without a rising edge.
+ */
+bool pulse_expect(pulse_detector *pd, const pulse_params *p, uint32_t t_ms)
+{
+  if (!pd->locked || pd->on) {
+    return true;
+  }
+
+  uint32_t elapsed = t_ms - pd->last_rise;
+  if (elapsed > p->miss_count * pd->period + p->guard_ms) {
+    pd->locked = false;
+    pd->matches = 0;
+    return true;
+  }
+
+  // window from guard before the predicted rise to guard after the fall
+  float phase = fmodf((float) elapsed, pd->period);
+  float on_time = pd->on_time > 0 ? pd->on_time : (float) p->guard_ms;
+  return phase >= pd->period - p->guard_ms || phase <= on_time + p->guard_ms;
+}
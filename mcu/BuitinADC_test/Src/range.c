@@ -0,0 +1,48 @@
+#include "range.h"
+#include "range_cal.h"
+#include <math.h>
+#include <string.h>
+
+/*
+ * Scale the channel powers and their cross term to field units, 1 being the
+ * on axis field 1 m from the beacon.
+ */
+void range_normalise(float *px, float *py, float *pxy)
+{
+  *px *= RANGE_CAL_SCALE_X;
+  *py *= RANGE_CAL_SCALE_Y;
+  if (pxy) {
+    *pxy *= sqrtf(RANGE_CAL_SCALE_X * RANGE_CAL_SCALE_Y);
+  }
+}
+
+/*
+ * Distance (m) for a normalised power. Below the table the longest distance
+ * is returned, above it the shortest.
+ */
+float range_lookup(float pn)
+{
+  if (!(pn > 0)) {
+    return range_cal_cm[0] * 0.01f;
+  }
+
+  uint32_t bits;
+  memcpy(&bits, &pn, sizeof(bits));
+  uint32_t k = bits >> RANGE_CAL_SHIFT;
+
+  if (k < RANGE_CAL_KEY0) {
+    k = RANGE_CAL_KEY0;
+  }
+  else if (k >= RANGE_CAL_KEY0 + RANGE_CAL_LEN) {
+    k = RANGE_CAL_KEY0 + RANGE_CAL_LEN - 1;
+  }
+  return range_cal_cm[k - RANGE_CAL_KEY0] * 0.01f;
+}
+
+/*
+ * Distance (m) from raw X and Y channel powers.
+ */
+float range_from_power(float px, float py)
+{
+  return range_lookup(px * RANGE_CAL_SCALE_X + py * RANGE_CAL_SCALE_Y);
+}
@@ -0,0 +1,136 @@
+#include "sdft.h"
+#include <math.h>
+
+/*
+ * Set up a window of n samples at freq (Hz) for input sampled at fs, handing
+ * out the bin every hop samples. r is the pole radius, SDFT_DAMPING unless
+ * the window is very long.
+ */
+void sdft_init(sdft_state *s, float freq, float fs, uint32_t n, uint32_t hop, float r)
+{
+  if (n > SDFT_MAX_N) n = SDFT_MAX_N;
+  if (n < 1) n = 1;
+  if (hop < 1) hop = 1;
+
+  const float omega = 2.0f * 3.14159265f * freq / fs;
+
+  s->n = n;
+  s->hop = hop;
+  s->rot_re = r * cosf(omega);
+  s->rot_im = r * sinf(omega);
+  s->scale = 2.0f / n;
+
+  // the sample leaving has been turned n times by the rounded step, weigh it
+  // by the same power of it so it cancels; from cos and sin of omega n the
+  // small mismatch would build up in the sum
+  double wr = 1;
+  double wi = 0;
+  for (uint32_t k = 0; k < n; k++) {
+    double t = wr * s->rot_re - wi * s->rot_im;
+    wi = wr * s->rot_im + wi * s->rot_re;
+    wr = t;
+  }
+  s->out_re = (float) wr;
+  s->out_im = (float) wi;
+  sdft_reset(s);
+}
+
+/*
+ * Empty the window, call between blocks that are not contiguous.
+ */
+void sdft_reset(sdft_state *s)
+{
+  s->s_re = 0;
+  s->s_im = 0;
+  s->head = 0;
+  s->wait = s->n;
+  for (uint32_t k = 0; k < s->n; k++) {
+    s->delay[k] = 0;
+  }
+}
+
+/*
+ * Run len samples through the window, less the dc operating point. Once the
+ * window is full a bin goes to out every hop samples; output j after a
+ * reset covers samples j * hop to j * hop + n - 1. Returns the count.
+ */
+uint32_t sdft_process(sdft_state *s, const int16_t *in, uint32_t len, int16_t dc, dsp_complex *out)
+{
+  const float rr = s->rot_re;
+  const float ri = s->rot_im;
+  const float orr = s->out_re;
+  const float ori = s->out_im;
+  const uint32_t n = s->n;
+
+  float sr = s->s_re;
+  float si = s->s_im;
+  uint32_t head = s->head;
+  uint32_t wait = s->wait;
+  uint32_t m = 0;
+
+  for (uint32_t i = 0; i < len; i++) {
+    int16_t x = in[i] - dc;
+    float old = s->delay[head];
+    s->delay[head] = x;
+    if (++head == n) {
+      head = 0;
+    }
+
+    // S = x + r exp(j omega) S - r^n exp(j omega n) x[-n]
+    float tr = rr * sr - ri * si + x - orr * old;
+    float ti = rr * si + ri * sr - ori * old;
+    sr = tr;
+    si = ti;
+
+    if (--wait == 0) {
+      out[m].re = sr * s->scale;
+      out[m].im = si * s->scale;
+      m++;
+      wait = s->hop;
+    }
+  }
+
+  s->s_re = sr;
+  s->s_im = si;
+  s->head = head;
+  s->wait = wait;
+  return m;
+}
+
+/*
+ * Place a pulse edge in a run of m sliding DFT powers, the window n and hop
+ * they were taken with. The edge is where the magnitude crosses half its
+ * largest value in the run, the window is then half over it.
+ *
+ * The full magnitude has to be in the run for the half to mean anything, so
+ * a rise needs a whole window after it and a fall one before it. Returns
+ * the edge in samples from the start of the run, or -1 if there is no such
+ * edge in the wanted direction.
+ */
+float sdft_edge(const float *power, uint32_t m, uint32_t n, uint32_t hop, bool rising)
+{
+  float peak = 0;
+  for (uint32_t j = 0; j < m; j++) {
+    peak = power[j] > peak ? power[j] : peak;
+  }
+  if (!(peak > 0)) {
+    return -1;
+  }
+
+  // half the magnitude is a quarter of the power
+  const float th = 0.25f * peak;
+  for (uint32_t j = 1; j < m; j++) {
+    bool below0 = power[j - 1] < th;
+    bool below1 = power[j] < th;
+    if (rising ? (below0 && !below1) : (!below0 && below1)) {
+      // the magnitude ramps linearly while the window crosses the edge
+      float a0 = sqrtf(power[j - 1]);
+      float a1 = sqrtf(power[j]);
+      float frac = (0.5f * sqrtf(peak) - a0) / (a1 - a0);
+      float e = (j - 1 + frac) * hop + 0.5f * n;
+      bool full = rising ? e <= (float) (m - 1) * hop : e >= (float) n;
+      return full ? e : -1;
+    }
+  }
+  return -1;
+}
@@ -0,0 +1,92 @@
+#include "spectrum.h"
+#include "dsp.h"
+#include <math.h>
+
+#ifdef ARM_MATH_CM7
+#include "arm_math.h"
+
+static arm_rfft_instance_q15 spec_fft;
+#endif
+
+// windowed samples are shifted up so full scale uses half the q15 range
+#define SPEC_INPUT_SHIFT 3
+
+/*
+ * Set up the FFT, once before the first survey.
+ */
+void spec_init(void)
+{
+#ifdef ARM_MATH_CM7
+  arm_rfft_init_q15(&spec_fft, SPEC_N, 0, 1);
+#endif
+}
+
+/*
+ * Real FFT of the SPEC_N samples in buf into work, bins 0 to SPEC_N / 2 - 1
+ * as re, im pairs. Each bin is the DFT over SPEC_N / 2, as arm_rfft_q15
+ * gives it, so a tone of amplitude A reads |z| = A.
+ */
+static void spec_fft_q15(int16_t *buf, int16_t *work)
+{
+#ifdef ARM_MATH_CM7
+  arm_rfft_q15(&spec_fft, buf, work);
+#else
+  for (uint32_t k = 0; k < SPEC_N / 2; k++) {
+    goertzel_plan plan;
+    goertzel_plan_init_bin(&plan, k, SPEC_N);
+    dsp_complex z = goertzel_bin_f32(&plan, buf);
+    work[2 * k] = (int16_t) lrintf(z.re);
+    work[2 * k + 1] = (int16_t) lrintf(z.im);
+  }
+#endif
+}
+
+/*
+ * Survey one burst. buf holds at least SPEC_N raw samples and is windowed in
+ * place, work takes 2 * SPEC_N values; both are overwritten. The window
+ * table of window_len points is read at every window_len / SPEC_N th point.
+ */
+void spec_run(int16_t *buf, int16_t *work, const int16_t *window, uint32_t window_len, int16_t dc, float fs,
+              spec_result *r)
+{
+  // window in place (q15, the burst's flattop peaks at 32766), its coherent
+  // gain for the full scale reference
+  int32_t wsum = 0;
+  for (uint32_t i = 0; i < SPEC_N; i++) {
+    int32_t w = window[i * window_len / SPEC_N];
+    wsum += w;
+    buf[i] = (int16_t) (((buf[i] - dc) * w) >> (15 - SPEC_INPUT_SHIFT));
+  }
+
+  spec_fft_q15(buf, work);
+
+  // a full scale sine reads this in its bin
+  float full = 2048.0f * (1 << SPEC_INPUT_SHIFT) * wsum / (32768.0f * SPEC_N);
+  const uint32_t per_band = SPEC_N / 2 / SPEC_BANDS;
+  const float bin_hz = fs / SPEC_N;
+
+  r->band_hz = bin_hz * per_band;
+  r->peak_db = -200.0f;
+  r->peak_hz = 0;
+  for (uint32_t b = 0; b < SPEC_BANDS; b++) {
+    uint32_t best = 0;
+    uint32_t best_k = b * per_band;
+    for (uint32_t k = b * per_band; k < (b + 1) * per_band; k++) {
+      int32_t re = work[2 * k];
+      int32_t im = work[2 * k + 1];
+      uint32_t p = (uint32_t) (re * re) + (uint32_t) (im * im);
+      if (p > best) {
+        best = p;
+        best_k = k;
+      }
+    }
+
+    // the floor of a q15 bin is a count
+    float db = 10 * log10f(fmaxf((float) best, 1.0f) / (full * full));
+    r->db[b] = db;
+    if (db > r->peak_db && best_k > 0) {
+      r->peak_db = db;
+      r->peak_hz = best_k * bin_hz;
+    }
+  }
+}
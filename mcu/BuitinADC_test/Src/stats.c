@@ -0,0 +1,83 @@
+#include "stats.h"
+
+/*
+ * Set up an empty window. buf, maxq and minq must each hold size elements.
+ */
+void stats_window_init(stats_window *w, float *buf, uint32_t *maxq, uint32_t *minq, uint32_t size)
+{
+  circ_buf_init_float(&w->circ, buf, size);
+  for (uint32_t i = 0; i < size; i++) {
+    buf[i] = 0;
+  }
+
+  w->count = 0;
+  w->sum = 0;
+  w->comp = 0;
+  w->maxq = maxq;
+  w->maxq_head = 0;
+  w->maxq_len = 0;
+  w->minq = minq;
+  w->minq_head = 0;
+  w->minq_len = 0;
+}
+
+/*
+ * Compensated add to the running sum.
+ */
+static inline void stats_sum_add(stats_window *w, float x)
+{
+  float y = x - w->comp;
+  float t = w->sum + y;
+  w->comp = (t - w->sum) - y;
+  w->sum = t;
+}
+
+/*
+ * Deque position helper, the deques are rings of circ.size entries.
+ */
+static inline uint32_t stats_q_pos(const stats_window *w, uint32_t head, uint32_t offset)
+{
+  uint32_t pos = head + offset;
+  return pos >= w->circ.size ? pos - w->circ.size : pos;
+}
+
+/*
+ * Add a sample, dropping the oldest one once the window is full.
+ */
+void stats_window_push(stats_window *w, float val)
+{
+  const uint32_t slot = w->circ.idx;
+  const float *buf = w->circ.buf;
+
+  // the sample in this slot leaves the window
+  if (w->count == w->circ.size) {
+    stats_sum_add(w, -buf[slot]);
+  }
+  else {
+    w->count++;
+  }
+  if (w->maxq_len && w->maxq[w->maxq_head] == slot) {
+    w->maxq_head = stats_q_pos(w, w->maxq_head, 1);
+    w->maxq_len--;
+  }
+  if (w->minq_len && w->minq[w->minq_head] == slot) {
+    w->minq_head = stats_q_pos(w, w->minq_head, 1);
+    w->minq_len--;
+  }
+
+  circ_buf_wr_float(&w->circ, val);
+  stats_sum_add(w, val);
+
+  // drop entries the new sample dominates, then append it
+  while (w->maxq_len && buf[w->maxq[stats_q_pos(w, w->maxq_head, w->maxq_len - 1)]] <= val) {
+    w->maxq_len--;
+  }
+  w->maxq[stats_q_pos(w, w->maxq_head, w->maxq_len)] = slot;
+  w->maxq_len++;
+
+  while (w->minq_len && buf[w->minq[stats_q_pos(w, w->minq_head, w->minq_len - 1)]] >= val) {
+    w->minq_len--;
+  }
+  w->minq[stats_q_pos(w, w->minq_head, w->minq_len)] = slot;
+  w->minq_len++;
+}
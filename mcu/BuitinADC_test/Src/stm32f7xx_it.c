@@ -208,3 +208,8 @@ void DMA2_Stream3_IRQHandler(void)
   ADC_DMA_Stream2_Handler();
 }
 
+void EXTI15_10_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(USER_Btn_Pin);
+}
+
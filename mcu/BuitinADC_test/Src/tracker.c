@@ -0,0 +1,390 @@
+#include "tracker.h"
+#include <math.h>
+
+// gain for period and amplitude updates
+#define TRACK_GAIN 0.25f
+
+void tracker_init(tracker *tr, const tracker_params *p)
+{
+  for (uint32_t i = 0; i < TRACK_MAX; i++) {
+    tr->tracks[i].active = false;
+    tr->tracks[i].id = 0;
+  }
+  tr->selected = -1;
+  tr->next_id = 1;
+  tr->in_pulse = false;
+  tr->nbursts = 0;
+  tr->coh_n = 0;
+  tr->sat = false;
+  if (p->cfar) {
+    // guidance tests the smoothed power, a mean over bursts
+    cfar_params cp = *p->cfar;
+    cp.avg = power_smoother_span(p->smooth);
+    cfar_init(&tr->noise, &cp);
+    tr->coh_alpha = cfar_alpha(tr->noise.window, tr->noise.rank, cp.looks, 1, cp.pfa);
+  }
+}
+
+/*
+ * Start a track in slot k from its first pulse.
+ */
+static void track_start(tracker *tr, const tracker_params *p, uint32_t k, uint32_t rise, float amp)
+{
+  track *tk = &tr->tracks[k];
+
+  tk->active = true;
+  tk->id = tr->next_id++;
+  tk->pulses = 1;
+  tk->last_rise = rise;
+  tk->period = 0;
+  tk->amp = amp;
+  tk->out.dir = STRAIGHT_AHEAD;
+  tk->out.heading_corr = 0;
+  tk->out.confidence = 0;
+  power_smoother_init(&tk->smoothx, p->smooth);
+  power_smoother_init(&tk->smoothy, p->smooth);
+  power_smoother_init(&tk->smoothc, p->smooth);
+  tk->cross = 0;
+  tk->saturated = false;
+  stats_window_init(&tk->avgx, tk->avgbufx, tk->avgqx[0], tk->avgqx[1], POWER_AVG_BUF_SIZE);
+  stats_window_init(&tk->avgy, tk->avgbufy, tk->avgqy[0], tk->avgqy[1], POWER_AVG_BUF_SIZE);
+  guidance_state_init(&tk->guidance, p->guidance);
+}
+
+/*
+ * How long a track lives without pulses.
+ */
+static uint32_t track_timeout(const track *tk, const tracker_params *p)
+{
+  float period = tk->period > 0 ? tk->period : (float) p->max_period_ms;
+  return (uint32_t) (p->miss_count * period) + p->min_period_ms;
+}
+
+/*
+ * Best matching active track for a pulse, -1 if none. Lower score is better,
+ * timing and amplitude errors are each normalised to their tolerance.
+ */
+static int32_t track_match(const tracker *tr, const tracker_params *p, uint32_t rise, float amp)
+{
+  int32_t best = -1;
+  float best_score = 3.0f;
+
+  for (uint32_t k = 0; k < TRACK_MAX; k++) {
+    const track *tk = &tr->tracks[k];
+    if (!tk->active) {
+      continue;
+    }
+
+    uint32_t dt = rise - tk->last_rise;
+    if (dt < p->min_period_ms) {
+      continue;
+    }
+
+    float amp_err = fabsf(10 * log10f(amp / tk->amp)) / p->amp_tol_db;
+    if (amp_err > 1) {
+      continue;
+    }
+
+    // unknown period, any plausible gap is an even match
+    float time_err = 0.5f;
+    if (tk->period > 0) {
+      uint32_t n = pulse_period_match(tk->period, dt, p->period_tol);
+      if (n == 0 || n > p->miss_count) {
+        continue;
+      }
+      time_err = fabsf(dt - n * tk->period) / (p->period_tol * tk->period);
+    }
+    else if (dt > p->max_period_ms) {
+      continue;
+    }
+
+    float score = amp_err + time_err;
+    if (score < best_score) {
+      best_score = score;
+      best = k;
+    }
+  }
+
+  return best;
+}
+
+/*
+ * Slot for a new track, a free one or else the one silent the longest.
+ */
+static uint32_t track_slot(const tracker *tr, uint32_t rise)
+{
+  uint32_t slot = 0;
+  uint32_t oldest = 0;
+
+  for (uint32_t k = 0; k < TRACK_MAX; k++) {
+    const track *tk = &tr->tracks[k];
+    if (!tk->active) {
+      return k;
+    }
+    if (rise - tk->last_rise > oldest) {
+      oldest = rise - tk->last_rise;
+      slot = k;
+    }
+  }
+  return slot;
+}
+
+/*
+ * Run the bursts of a pulse through a track's smoothing and guidance. Returns
+ * true if guidance ran.
+ */
+static bool track_feed(tracker *tr, const tracker_params *p, track *tk)
+{
+  bool updated = false;
+
+  // gate guidance on the noise floor once it is known. The floor is one
+  // burst's X + Y power, guidance compares that sum after smoothing, which
+  // the detector's factor is solved for. Coherent pulse powers are the same
+  // in every burst so smoothing averages no noise out, but they hold 1/n of
+  // a burst's noise, so the one reading factor is scaled by n
+  GuidanceParams gp = *p->guidance;
+  if (p->cfar && cfar_ready(&tr->noise)) {
+    gp.min_valid_mag = tr->coh_n ? tr->coh_alpha * cfar_floor(&tr->noise) / tr->coh_n
+                                 : cfar_threshold(&tr->noise);
+  }
+
+  for (uint32_t i = 0; i < tr->nbursts; i++) {
+    power_smoother_push(&tk->smoothx, tr->px[i]);
+    power_smoother_push(&tk->smoothc, tr->pc[i]);
+    if (power_smoother_push(&tk->smoothy, tr->py[i])) {
+      stats_window_push(&tk->avgx, tk->smoothx.guide_out);
+      stats_window_push(&tk->avgy, tk->smoothy.guide_out);
+      tk->cross = tk->smoothc.guide_out;
+      tk->out = guidance_step_ext(tk->avgx.circ.buf, tk->avgy.circ.buf, tk->avgx.circ.idx, tk->avgy.circ.idx,
+                                  &tk->cross, &tk->guidance, &gp);
+      if (tk->saturated) {
+        tk->out.confidence *= 0.5f;
+      }
+      updated = true;
+    }
+  }
+  return updated;
+}
+
+/*
+ * Other trains whose predicted rise falls inside the pulse just assigned to
+ * track k were hidden by it, as the detector sees one pulse. Those tracks
+ * coast on their prediction rather than count a miss, so two transmitters
+ * drifting through each other both stay tracked.
+ */
+static void tracker_coast(tracker *tr, const tracker_params *p, uint32_t k, uint32_t fall)
+{
+  for (uint32_t j = 0; j < TRACK_MAX; j++) {
+    track *tk = &tr->tracks[j];
+    if (j == k || !tk->active || tk->period <= 0) {
+      continue;
+    }
+
+    // first predicted rise no earlier than the tolerance before this one
+    float from = (float) (tr->rise - tk->last_rise) - p->period_tol * tk->period;
+    float n = ceilf(from / tk->period);
+    if (n < 1) {
+      n = 1;
+    }
+    float pred = n * tk->period;
+    if (pred <= (float) (fall - tk->last_rise)) {
+      tk->last_rise += (uint32_t) lrintf(pred);
+    }
+  }
+}
+
+/*
+ * Assign a finished pulse to a track. Returns the track index if its guidance
+ * ran, else -1.
+ */
+static int32_t tracker_end_pulse(tracker *tr, const tracker_params *p, uint32_t fall)
+{
+  if (tr->nbursts == 0) {
+    return -1;
+  }
+
+  float amp = 0;
+  for (uint32_t i = 0; i < tr->nbursts; i++) {
+    amp += tr->px[i] + tr->py[i];
+  }
+  amp /= tr->nbursts;
+
+  int32_t k = track_match(tr, p, tr->rise, amp);
+  if (k < 0) {
+    k = track_slot(tr, tr->rise);
+    track_start(tr, p, k, tr->rise, amp);
+  }
+  else {
+    track *tk = &tr->tracks[k];
+    uint32_t dt = tr->rise - tk->last_rise;
+    uint32_t n = pulse_period_match(tk->period, dt, p->period_tol);
+
+    if (n) {
+      tk->period += TRACK_GAIN * ((float) dt / n - tk->period);
+    }
+    else if (dt <= p->max_period_ms) {
+      // second pulse gives the first period guess
+      tk->period = dt;
+    }
+    tk->amp += TRACK_GAIN * (amp - tk->amp);
+    tk->last_rise = tr->rise;
+    tk->pulses++;
+  }
+
+  // keep guiding to something
+  if (tr->selected < 0) {
+    tr->selected = k;
+  }
+
+  tracker_coast(tr, p, k, fall);
+
+  tr->tracks[k].saturated = tr->sat;
+  return track_feed(tr, p, &tr->tracks[k]) ? k : -1;
+}
+
+/*
+ * Drop tracks that have been silent too long.
+ */
+static void tracker_expire(tracker *tr, const tracker_params *p, uint32_t t_ms)
+{
+  for (uint32_t k = 0; k < TRACK_MAX; k++) {
+    track *tk = &tr->tracks[k];
+    if (tk->active && t_ms - tk->last_rise > track_timeout(tk, p)) {
+      tk->active = false;
+      if (tr->selected == (int32_t) k) {
+        tr->selected = -1;
+        tracker_select_next(tr);
+      }
+    }
+  }
+}
+
+/*
+ * Feed one burst with its pulse detector event and whether the ADC clipped.
+ * Pulses are assigned when they end, so returns the index of a track whose
+ * guidance just ran, or -1.
+ */
+int32_t tracker_push(tracker *tr, const tracker_params *p, uint32_t t_ms, pulse_event ev, float px, float py, float pxy,
+                     bool sat)
+{
+  int32_t updated = -1;
+
+  switch (ev) {
+    case PULSE_RISE:
+      tr->in_pulse = true;
+      tr->rise = t_ms;
+      tr->nbursts = 0;
+      tr->coh_n = 0;
+      tr->sat = false;
+      // fall through
+    case PULSE_ON:
+      if (tr->in_pulse && tr->nbursts < TRACK_PULSE_BURSTS) {
+        tr->px[tr->nbursts] = px;
+        tr->py[tr->nbursts] = py;
+        tr->pc[tr->nbursts] = pxy;
+        tr->nbursts++;
+        tr->sat |= sat;
+      }
+    break;
+    case PULSE_FALL:
+      if (tr->in_pulse) {
+        updated = tracker_end_pulse(tr, p, t_ms);
+      }
+      tr->in_pulse = false;
+    break;
+    case PULSE_OFF:
+    default:
+    break;
+  }
+
+  // the burst after a pulse is already off
+  if (p->cfar && (ev == PULSE_OFF || ev == PULSE_FALL)) {
+    cfar_push(&tr->noise, px + py);
+  }
+
+  tracker_expire(tr, p, t_ms);
+  return updated;
+}
+
+/*
+ * Replace the powers of the pulse being collected, e.g. with its coherent
+ * sum over n bursts, before the PULSE_FALL push hands it to a track. Every
+ * burst gets the same reading so the smoothers still advance once per burst.
+ * The pulse is gated as one reading with the noise gate lowered by n, pass
+ * 1 for powers that carry a single burst's noise.
+ */
+void tracker_pulse_power(tracker *tr, float px, float py, float pxy, uint32_t n)
+{
+  tr->coh_n = n ? n : 1;
+  for (uint32_t i = 0; i < tr->nbursts; i++) {
+    tr->px[i] = px;
+    tr->py[i] = py;
+    tr->pc[i] = pxy;
+  }
+}
+
+/*
+ * Replace the rise time of the pulse being collected, taken from the burst
+ * that raised PULSE_RISE, with the edge placed inside a burst. Call after
+ * that push, on the same ms clock; periods and matching then follow the
+ * edge rather than the burst grid.
+ */
+void tracker_pulse_rise(tracker *tr, uint32_t rise_ms)
+{
+  if (tr->in_pulse) {
+    tr->rise = rise_ms;
+  }
+}
+
+/*
+ * Number of active tracks.
+ */
+uint32_t tracker_count(const tracker *tr)
+{
+  uint32_t n = 0;
+  for (uint32_t k = 0; k < TRACK_MAX; k++) {
+    n += tr->tracks[k].active;
+  }
+  return n;
+}
+
+/*
+ * True if a burst at t_ms should be processed. The pulse detector learns a
+ * single period, so its window (pulse_expect()) only gates while at most one
+ * transmitter is tracked; with more, every burst is taken.
+ */
+bool tracker_expect(const tracker *tr, pulse_detector *pd, const pulse_params *pp, uint32_t t_ms)
+{
+  // always asked, it drops a stale lock
+  bool due = pulse_expect(pd, pp, t_ms);
+  return due || tracker_count(tr) > 1;
+}
+
+/*
+ * Guide to the track with this id. Returns false if it is not active.
+ */
+bool tracker_select(tracker *tr, uint32_t id)
+{
+  for (uint32_t k = 0; k < TRACK_MAX; k++) {
+    if (tr->tracks[k].active && tr->tracks[k].id == id) {
+      tr->selected = k;
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Move the selection to the next active track, e.g. from a button press.
+ */
+void tracker_select_next(tracker *tr)
+{
+  for (uint32_t i = 1; i <= TRACK_MAX; i++) {
+    uint32_t k = (uint32_t) (tr->selected + i) % TRACK_MAX;
+    if (tr->tracks[k].active) {
+      tr->selected = k;
+      return;
+    }
+  }
+  tr->selected = -1;
+}
@@ -0,0 +1,107 @@
+/*
+ * Instruction count benchmark for QEMU.
+ *
+ * Runs every kernel in bench_kernels and prints one JSON line per kernel over
+ * semihosting. QEMU must run with -icount shift=0, so virtual time advances
+ * 1 ns per retired instruction. SysTick counts the 25 MHz mps2 system clock,
+ * one tick is therefore 40 instructions.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include "bench_kernels.h"
+
+/***********************
+ * Defines
+ * ********************/
+
+#define SYST_CSR (*(volatile uint32_t *) 0xE000E010)
+#define SYST_RVR (*(volatile uint32_t *) 0xE000E014)
+#define SYST_CVR (*(volatile uint32_t *) 0xE000E018)
+
+#define SYST_RELOAD 0x00FFFFFFu
+
+// mps2 SYSCLK, and the -icount shift the harness is run with
+#define QEMU_SYSCLK_HZ 25000000u
+#define ICOUNT_SHIFT 0
+#define INSN_PER_TICK ((1000000000u / QEMU_SYSCLK_HZ) >> ICOUNT_SHIFT)
+
+#define BENCH_REPS 10
+
+/*********************
+ * Globals
+ * ******************/
+
+static volatile uint32_t systick_wraps;
+
+// keeps kernel results alive
+volatile float bench_sink;
+
+extern void initialise_monitor_handles(void);
+
+/***************************
+ * Functions
+ * *************************/
+
+void SysTick_Handler(void)
+{
+  systick_wraps++;
+}
+
+/*
+ * Free running tick count, extended past 24 bits by the wrap interrupt.
+ */
+static uint64_t ticks_now(void)
+{
+  uint32_t wraps;
+  uint32_t val;
+
+  do {
+    wraps = systick_wraps;
+    val = SYST_CVR;
+  } while (wraps != systick_wraps);
+
+  return ((uint64_t) wraps * (SYST_RELOAD + 1)) + (SYST_RELOAD - val);
+}
+
+int main(void)
+{
+  initialise_monitor_handles();
+
+  // processor clock, interrupt on wrap, enable
+  SYST_RVR = SYST_RELOAD;
+  SYST_CVR = 0;
+  SYST_CSR = 0x7;
+
+  bench_init();
+
+  printf("{\"target\":\"qemu-mps2-an500\",\"icount_shift\":%d,\"reps\":%d}\n", ICOUNT_SHIFT, BENCH_REPS);
+
+  for (uint32_t k = 0; k < bench_kernel_count; k++) {
+    const bench_kernel *kern = &bench_kernels[k];
+    uint64_t total = 0;
+
+    // first run is a warm up and is not counted
+    for (int rep = -1; rep < BENCH_REPS; rep++) {
+      if (kern->prepare) {
+        kern->prepare();
+      }
+
+      uint64_t start = ticks_now();
+      bench_sink = kern->run();
+      uint64_t elapsed = ticks_now() - start;
+
+      if (rep >= 0) {
+        total += elapsed;
+      }
+    }
+
+    uint64_t insns = (total * INSN_PER_TICK) / BENCH_REPS;
+
+    printf("{\"kernel\":\"%s\",\"target\":\"qemu\",\"samples\":%lu,\"instructions\":%lu,"
+           "\"insn_per_sample\":%.3f}\n",
+           kern->name, (unsigned long) kern->samples, (unsigned long) insns,
+           (double) insns / kern->samples);
+  }
+
+  return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * Minimal startup for the QEMU mps2-an500 machine.
+ *
+ * Enables the FPU, clears .bss, runs static constructors and calls main().
+ * .data is placed in RAM directly by the QEMU ELF loader.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+
+#define SCB_CPACR (*(volatile uint32_t *) 0xE000ED88)
+
+extern uint32_t _estack;
+extern uint32_t __bss_start__;
+extern uint32_t __bss_end__;
+
+extern int main(void);
+extern void __libc_init_array(void);
+
+void Reset_Handler(void);
+void Default_Handler(void);
+void NMI_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void HardFault_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void MemManage_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void BusFault_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void UsageFault_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void SVC_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void DebugMon_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void PendSV_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void SysTick_Handler(void) __attribute__((weak, alias("Default_Handler")));
+
+typedef struct {
+  uint32_t *initial_sp;
+  void (*handlers[15])(void);
+} vector_table_t;
+
+// core exceptions only, the benchmark uses no peripherals besides SysTick
+__attribute__((section(".isr_vector"), used))
+const vector_table_t vector_table = {
+  .initial_sp = &_estack,
+  .handlers = {
+    Reset_Handler,
+    NMI_Handler,
+    HardFault_Handler,
+    MemManage_Handler,
+    BusFault_Handler,
+    UsageFault_Handler,
+    0, 0, 0, 0,
+    SVC_Handler,
+    DebugMon_Handler,
+    0,
+    PendSV_Handler,
+    SysTick_Handler,
+  },
+};
+
+// crti/crtn are not linked (-nostartfiles)
+void _init(void) {}
+void _fini(void) {}
+
+void Reset_Handler(void)
+{
+  // full access to CP10 and CP11 (FPU)
+  SCB_CPACR |= (0xFu << 20);
+  __asm volatile ("dsb\n\tisb");
+
+  for (uint32_t *p = &__bss_start__; p < &__bss_end__; p++) {
+    *p = 0;
+  }
+
+  __libc_init_array();
+
+  exit(main());
+}
+
+void Default_Handler(void)
+{
+  // semihosting exit so a fault doesn't hang the run
+  exit(2);
+}
@@ -0,0 +1,110 @@
+'''
+Plan a bandpass undersampling rate for the builtin ADC.
+
+Every rate the STM32F7 ADC can run continuously (PCLK2 / prescaler /
+(sampling time + 12 cycles)) is checked for where the carrier lands once
+sampled:
+
+    if       the alias of the carrier, folded into 0..fs/2
+    zone     Nyquist zone the carrier sits in, even zones are inverted
+    edge     room between the filter passband and DC or fs/2 after folding
+    guard    distance from the passband edge to the nearest other RF band
+             that folds onto it, the front end filter must reject there
+    n, k     burst length for --burst-ms and its Goertzel bin, with the
+             distance of the IF from the bin centre
+
+Rates are listed lowest first among those whose guard and edge are at least
+--min-guard and --min-edge, and with --max-k-off whose IF is that close to a
+bin centre (freq.c then measures without the window, see FREQ_RECT_CENTRED). With --fs only that rate is analysed, and the
+RF frequencies folding onto the IF are listed.
+'''
+import argparse
+import math
+
+PRESCALERS = (2, 4, 6, 8)
+SAMPLING_CYCLES = (3, 15, 28, 56, 84, 112, 144, 480)
+CONV_CYCLES = 12
+
+
+def fold(f, fs):
+    '''
+    Alias of f in 0..fs/2 and its Nyquist zone (1 is baseband).
+    '''
+    zone = int(2 * f // fs) + 1
+    r = math.fmod(f, fs)
+    if r > fs / 2:
+        r = fs - r
+    return r, zone
+
+
+def plan(fs, carrier, bw, burst_ms):
+    f_if, zone = fold(carrier, fs)
+    edge = min(f_if - bw / 2, fs / 2 - f_if - bw / 2)
+    guard = min(2 * f_if, fs - 2 * f_if) - bw
+    n = int(round(fs * burst_ms / 1000))
+    k = f_if * n / fs
+    return {
+        'fs': fs, 'if': f_if, 'zone': zone, 'edge': edge, 'guard': guard,
+        'n': n, 'k': int(round(k)), 'k_off': k - round(k),
+    }
+
+
+def images(fs, carrier, f_if, span):
+    '''
+    RF frequencies within span of the carrier that fold onto f_if.
+    '''
+    out = []
+    m0 = int((carrier - span) // fs)
+    m1 = int((carrier + span) // fs) + 1
+    for m in range(max(m0, 0), m1 + 1):
+        for f in (m * fs + f_if, m * fs - f_if):
+            if f > 0 and abs(f - carrier) <= span and abs(f - carrier) > 1:
+                out.append(f)
+    return sorted(set(out))
+
+
+def print_row(p, fs_ref):
+    inv = ' inv' if p['zone'] % 2 == 0 else ''
+    print(f"{p['fs']:10.0f} {p['if']:9.0f} {p['zone']:3d}{inv:4s} {p['edge']:8.0f} {p['guard']:8.0f} "
+          f"{p['n']:6d} {p['k']:5d} {p['k_off']:+6.2f} {fs_ref / p['fs']:6.1f}x")
+
+
+if __name__ == '__main__':
+
+    parser = argparse.ArgumentParser("alias-plan")
+    parser.add_argument("--carrier", type=float, default=457000.0)
+    parser.add_argument("--bw", type=float, default=10000.0, help="front end filter passband")
+    parser.add_argument("--pclk", type=float, default=108e6, help="APB2 clock")
+    parser.add_argument("--burst-ms", type=float, default=1.0)
+    parser.add_argument("--min-guard", type=float, default=50000.0)
+    parser.add_argument("--min-edge", type=float, default=10000.0)
+    parser.add_argument("--max-k-off", type=float, help="only rates with the IF this close to a bin centre")
+    parser.add_argument("--fs", type=float, help="analyse this rate only")
+    args = parser.parse_args()
+
+    # the 3.6 MS/s mode all the savings are measured against
+    fs_ref = args.pclk / 2 / (3 + CONV_CYCLES)
+
+    print(f"{'fs':>10s} {'if':>9s} {'zone':>7s} {'edge':>8s} {'guard':>8s} {'n':>6s} {'k':>5s} {'k off':>6s} {'saving':>7s}")
+
+    if args.fs:
+        p = plan(args.fs, args.carrier, args.bw, args.burst_ms)
+        print_row(p, fs_ref)
+        print()
+        print('RF frequencies folding onto the IF:')
+        for f in images(args.fs, args.carrier, p['if'], 4 * args.fs):
+            print(f'  {f:10.0f} Hz  ({f - args.carrier:+9.0f})')
+    else:
+        rows = []
+        for div in PRESCALERS:
+            for smp in SAMPLING_CYCLES:
+                fs = args.pclk / div / (smp + CONV_CYCLES)
+                p = plan(fs, args.carrier, args.bw, args.burst_ms)
+                p['cfg'] = f'PCLK_DIV{div}, {smp} cycles'
+                rows.append(p)
+        ok = [p for p in rows if p['guard'] >= args.min_guard and p['edge'] >= args.min_edge]
+        if args.max_k_off is not None:
+            ok = [p for p in ok if abs(p['k_off']) <= args.max_k_off]
+        for p in sorted(ok, key=lambda p: p['fs']):
+            print_row(p, fs_ref)
+            print(f"{'':10s} {p['cfg']}")
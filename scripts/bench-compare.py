@@ -0,0 +1,67 @@
+'''
+Compare two benchmark logs (one JSON object per line) kernel by kernel.
+
+Works with the DSP_Bench UART output (cycles_per_sample), the host
+benchmark output (ns_per_sample) and the QEMU_Bench output
+(insn_per_sample). Lines that are not JSON are ignored, so a raw serial
+capture can be passed in directly.
+'''
+import argparse
+import json
+import sys
+
+METRICS = ['cycles_per_sample', 'ns_per_sample', 'insn_per_sample']
+
+
+def load(path):
+    '''
+    Return {(kernel, variant): record} for every kernel line in a log.
+    '''
+    results = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith('{'):
+                continue
+            try:
+                rec = json.loads(line)
+            except json.JSONDecodeError:
+                continue
+            if 'kernel' not in rec:
+                continue
+            variant = rec.get('cache', rec.get('target', ''))
+            results[(rec['kernel'], variant)] = rec
+    return results
+
+
+def pick_metric(records, requested):
+    if requested:
+        return requested
+    for rec in records:
+        for m in METRICS:
+            if m in rec:
+                return m
+    print('No known metric in logs')
+    sys.exit(1)
+
+
+if __name__ == '__main__':
+
+    parser = argparse.ArgumentParser("bench-compare")
+    parser.add_argument("baseline", type=str)
+    parser.add_argument("candidate", type=str)
+    parser.add_argument("--metric", type=str, default=None)
+    args = parser.parse_args()
+
+    base = load(args.baseline)
+    cand = load(args.candidate)
+    metric = pick_metric(list(base.values()) + list(cand.values()), args.metric)
+
+    print(f'{"kernel":<28}{"variant":<10}{"baseline":>12}{"candidate":>12}{"change":>10}')
+    for key in sorted(set(base) | set(cand)):
+        b = base.get(key, {}).get(metric)
+        c = cand.get(key, {}).get(metric)
+        b_str = f'{b:.3f}' if b is not None else '-'
+        c_str = f'{c:.3f}' if c is not None else '-'
+        change = f'{100.0 * (c - b) / b:+.1f}%' if b and c is not None else ''
+        print(f'{key[0]:<28}{key[1]:<10}{b_str:>12}{c_str:>12}{change:>10}')
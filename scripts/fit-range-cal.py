@@ -0,0 +1,168 @@
+'''
+Fit the power to distance calibration and write Inc/range_cal.h.
+
+The input is a CSV recorded with the beacon on the antenna's axis and the
+antenna turned for the strongest reading, one row per reading:
+
+    channel,distance_m,power_db
+    x,1.0,108.7
+    y,1.0,109.9
+    ...
+
+power_db is 10 log10 of the smoothed Goertzel power, as printed over UART
+(a `power` column with the linear value works too). Per channel the fit is
+the near field model
+
+    power_db = gain_db - 10 n log10(distance)
+
+with n = 6 (field falling as 1/r^3) unless --free-exponent is given. The
+firmware divides each channel's power by its gain, adds them and looks the
+sum up in one table indexed by the float's exponent and top mantissa bits,
+so no log is needed on the device.
+
+Without a recording, --gain-db GX GY writes a nominal header.
+'''
+import argparse
+import csv
+import math
+import struct
+import sys
+
+# table steps per octave of power, 3 mantissa bits
+MANT_BITS = 3
+
+
+def fit_channel(rows, exponent=None):
+    '''
+    Least squares fit of power_db against log10(distance), with the exponent
+    fixed or (None) fitted too. Returns (gain_db, exponent, rms_db).
+    '''
+    xs = [math.log10(d) for d, _ in rows]
+    ys = [p for _, p in rows]
+    n = len(xs)
+    if exponent is None:
+        if n < 2:
+            print('Need at least two distances per channel for a free exponent')
+            sys.exit(1)
+        mx = sum(xs) / n
+        my = sum(ys) / n
+        sxx = sum((x - mx) ** 2 for x in xs)
+        sxy = sum((x - mx) * (y - my) for x, y in zip(xs, ys))
+        slope = sxy / sxx
+        exponent = -slope / 10
+        gain = my - slope * mx
+    else:
+        gain = sum(y + 10 * exponent * x for x, y in zip(xs, ys)) / n
+    rms = math.sqrt(sum((gain - 10 * exponent * x - y) ** 2 for x, y in zip(xs, ys)) / n)
+    return gain, exponent, rms
+
+
+def load(path):
+    '''
+    Return {'x': [(distance_m, power_db)], 'y': [...]}.
+    '''
+    data = {'x': [], 'y': []}
+    with open(path, newline='') as f:
+        for row in csv.DictReader(f):
+            ch = row['channel'].strip().lower()
+            if ch not in data:
+                continue
+            d = float(row['distance_m'])
+            if 'power_db' in row and row['power_db']:
+                p = float(row['power_db'])
+            else:
+                p = 10 * math.log10(float(row['power']))
+            if d > 0:
+                data[ch].append((d, p))
+    return data
+
+
+def key(value):
+    '''
+    Table key of a positive float: exponent and top mantissa bits.
+    '''
+    bits = struct.unpack('<I', struct.pack('<f', value))[0]
+    return bits >> (23 - MANT_BITS)
+
+
+def key_centre(k):
+    '''
+    Geometric centre of the values sharing a key.
+    '''
+    lo = struct.unpack('<f', struct.pack('<I', k << (23 - MANT_BITS)))[0]
+    hi = struct.unpack('<f', struct.pack('<I', (k + 1) << (23 - MANT_BITS)))[0]
+    return math.sqrt(lo * hi)
+
+
+def write_header(path, gains, exponent, min_m, max_m, source):
+    k0 = key(max_m ** -exponent)
+    k1 = key(min_m ** -exponent)
+    table = []
+    for k in range(k0, k1 + 1):
+        r = key_centre(k) ** (-1 / exponent)
+        table.append(min(int(round(r * 100)), 65535))
+
+    with open(path, 'w') as f:
+        f.write('/*\n')
+        f.write(' * Power to distance calibration, generated by scripts/fit-range-cal.py.\n')
+        f.write(f' * {source}\n')
+        f.write(' *\n')
+        f.write(' * Normalised power is the sum over channels of power * RANGE_CAL_SCALE.\n')
+        f.write(' * The table holds the distance in cm per key, the float bits shifted down\n')
+        f.write(' * by RANGE_CAL_SHIFT, counted from RANGE_CAL_KEY0.\n')
+        f.write(' */\n\n')
+        f.write('#ifndef RANGE_CAL_H\n#define RANGE_CAL_H\n\n#include <stdint.h>\n\n')
+        f.write(f'#define RANGE_CAL_GAIN_DB_X {gains[0]:.2f}f\n')
+        f.write(f'#define RANGE_CAL_GAIN_DB_Y {gains[1]:.2f}f\n')
+        f.write(f'#define RANGE_CAL_SCALE_X {10 ** (-gains[0] / 10):.6e}f\n')
+        f.write(f'#define RANGE_CAL_SCALE_Y {10 ** (-gains[1] / 10):.6e}f\n')
+        f.write(f'#define RANGE_CAL_EXPONENT {exponent:.3f}f\n')
+        f.write(f'#define RANGE_CAL_SHIFT {23 - MANT_BITS}\n')
+        f.write(f'#define RANGE_CAL_KEY0 {k0}u\n')
+        f.write(f'#define RANGE_CAL_LEN {len(table)}u\n\n')
+        f.write('static const uint16_t range_cal_cm[RANGE_CAL_LEN] = {\n')
+        for i in range(0, len(table), 12):
+            f.write(','.join(str(v) for v in table[i:i + 12]))
+            f.write(',\n' if i + 12 < len(table) else '\n')
+        f.write('};\n\n#endif // RANGE_CAL_H\n')
+    print(f'Wrote {len(table)} entries ({2 * len(table)} bytes) to {path}')
+
+
+if __name__ == '__main__':
+
+    parser = argparse.ArgumentParser("fit-range-cal")
+    parser.add_argument("recording", nargs='?', help="CSV of channel,distance_m,power_db")
+    parser.add_argument("-o", "--output", default="mcu/BuitinADC_test/Inc/range_cal.h")
+    parser.add_argument("--free-exponent", action="store_true", help="fit the fall off too, default 1/r^3 field")
+    parser.add_argument("--gain-db", nargs=2, type=float, metavar=('GX', 'GY'), help="nominal gains, no recording")
+    parser.add_argument("--min-m", type=float, default=0.2)
+    parser.add_argument("--max-m", type=float, default=100.0)
+    args = parser.parse_args()
+
+    if args.gain_db:
+        gains = args.gain_db
+        exponent = 6.0
+        source = f'Nominal gains {gains[0]:.1f} / {gains[1]:.1f} dB, no recording.'
+    elif args.recording:
+        data = load(args.recording)
+        for ch in ('x', 'y'):
+            if not data[ch]:
+                print(f'No readings for channel {ch}')
+                sys.exit(1)
+
+        # one table serves both channels, so they share the exponent
+        exponent = 6.0
+        if args.free_exponent:
+            exponent = sum(fit_channel(data[ch])[1] for ch in ('x', 'y')) / 2
+
+        gains = []
+        for ch in ('x', 'y'):
+            g, n, rms = fit_channel(data[ch], exponent)
+            print(f'{ch}: gain {g:.2f} dB, exponent {n:.2f}, rms {rms:.2f} dB over {len(data[ch])} readings')
+            gains.append(g)
+        source = f'Fitted to {args.recording}.'
+    else:
+        parser.print_usage()
+        sys.exit(1)
+
+    write_header(args.output, gains, exponent, args.min_m, args.max_m, source)
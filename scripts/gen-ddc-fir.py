@@ -0,0 +1,145 @@
+'''
+Design the downconverter's decimating FIR and NCO table, write Inc/ddc_coeffs.h.
+
+The chain in ddc.c mixes the ADC data to baseband, decimates in a third
+order CIC and by 4 in this FIR. The defaults are for the 3.6 MS/s mode, a
+CIC decimating by 36 so the FIR runs at 100 kS/s. For the undersampling
+mode (ACQ_UNDERSAMPLE) use
+
+    --fs 140625 --cic-r 3 --pass-hz 2000 --stop-hz 7000 -o .../Inc/ddc_coeffs_undersample.h
+
+The taps are a Kaiser windowed lowpass whose passband is raised by the
+inverse CIC droop. The DC gain also takes up the CIC output shift, so a tone
+of amplitude A counts reads as |z| = 4 A at the output.
+
+Plain Python, no numpy needed.
+'''
+import argparse
+import math
+import os
+
+FS_IN = 3600000.0
+CIC_R = 36
+CIC_ORDER = 3
+FIR_R = 4
+NCO_BITS = 10
+
+
+def cic_response(f):
+    '''
+    Normalised CIC magnitude at f (Hz, input rate).
+    '''
+    x = math.pi * f / FS_IN
+    if x == 0:
+        return 1.0
+    return abs(math.sin(CIC_R * x) / (CIC_R * math.sin(x))) ** CIC_ORDER
+
+
+def bessel_i0(x):
+    s, term, k = 1.0, 1.0, 1
+    while term > 1e-12 * s:
+        term *= (x / (2 * k)) ** 2
+        s += term
+        k += 1
+    return s
+
+
+def desired(f, pass_hz, stop_hz):
+    '''
+    Wanted response: CIC compensation in the passband, a raised cosine down
+    to zero at the stopband edge.
+    '''
+    if f <= pass_hz:
+        return 1 / cic_response(f)
+    if f >= stop_hz:
+        return 0.0
+    t = (f - pass_hz) / (stop_hz - pass_hz)
+    return 0.5 * (1 + math.cos(math.pi * t)) / cic_response(pass_hz)
+
+
+def design(taps, pass_hz, stop_hz, beta, grid=4096):
+    fs = FS_IN / CIC_R
+    c = (taps - 1) / 2
+    h = []
+    for n in range(taps):
+        # inverse transform of the even wanted response, midpoint rule
+        acc = 0.0
+        for k in range(grid):
+            f = (k + 0.5) / grid * fs / 2
+            acc += desired(f, pass_hz, stop_hz) * math.cos(2 * math.pi * f / fs * (n - c))
+        h.append(acc / grid)
+        w = bessel_i0(beta * math.sqrt(1 - ((n - c) / c) ** 2)) / bessel_i0(beta)
+        h[n] *= w
+    dc = sum(h)
+    return [v / dc for v in h]
+
+
+def response_db(h, f):
+    fs = FS_IN / CIC_R
+    c = (len(h) - 1) / 2
+    a = sum(v * math.cos(2 * math.pi * f / fs * (n - c)) for n, v in enumerate(h))
+    return 20 * math.log10(max(abs(a * cic_response(f)), 1e-12))
+
+
+if __name__ == '__main__':
+
+    parser = argparse.ArgumentParser("gen-ddc-fir")
+    parser.add_argument("-o", "--output", default="mcu/BuitinADC_test/Inc/ddc_coeffs.h")
+    parser.add_argument("--fs", type=float, default=FS_IN, help="ADC sample rate")
+    parser.add_argument("--cic-r", type=int, default=CIC_R, help="CIC decimation")
+    parser.add_argument("--taps", type=int, default=32)
+    parser.add_argument("--pass-hz", type=float, default=4000.0, help="edge of the flat passband")
+    parser.add_argument("--stop-hz", type=float, default=16000.0, help="wanted response reaches zero")
+    parser.add_argument("--beta", type=float, default=6.0, help="Kaiser window shape")
+    args = parser.parse_args()
+    FS_IN = args.fs
+    CIC_R = args.cic_r
+
+    # smallest shift that brings the CIC gain to at most 1
+    CIC_SHIFT = math.ceil(math.log2(CIC_R ** CIC_ORDER))
+
+    h = design(args.taps, args.pass_hz, args.stop_hz, args.beta)
+
+    # DC gain makes up for the CIC shift
+    gain = 2 ** CIC_SHIFT / CIC_R ** CIC_ORDER
+    taps_q15 = [int(round(v * gain * 32768)) for v in h]
+
+    fs_out = FS_IN / CIC_R / FIR_R
+    ripple = max(abs(response_db(h, f)) for f in range(0, int(args.pass_hz) + 1, 100))
+    alias = max(response_db(h, f) for f in range(int(fs_out - args.pass_hz), int(FS_IN / CIC_R / 2) + 1, 100))
+    print(f'{args.taps} taps, passband ripple {ripple:.2f} dB to {args.pass_hz:.0f} Hz, '
+          f'aliases into it at most {alias:.1f} dB')
+
+    nco_len = 1 << NCO_BITS
+    nco = [int(round(32767 * math.sin(2 * math.pi * i / nco_len))) for i in range(nco_len + nco_len // 4)]
+
+    with open(args.output, 'w') as f:
+        f.write('/*\n')
+        f.write(' * Downconverter coefficients, generated by scripts/gen-ddc-fir.py.\n')
+        f.write(f' * ADC at {FS_IN:.0f} S/s, CIC decimating by {CIC_R}.\n')
+        f.write(f' * {args.taps} taps, passband {args.pass_hz:.0f} Hz, stopband {args.stop_hz:.0f} Hz, '
+                f'Kaiser beta {args.beta:.1f}.\n')
+        f.write(f' * Passband ripple {ripple:.2f} dB, aliases into the passband at most {alias:.1f} dB.\n')
+        f.write(' *\n')
+        f.write(f' * The FIR runs after the CIC at {FS_IN / CIC_R:.0f} S/s, its DC gain includes the CIC\n')
+        f.write(' * output shift. The NCO table is a Q15 sine with a quarter period repeated\n')
+        f.write(' * at the end, so the cosine is read DDC_NCO_LEN / 4 further on.\n')
+        f.write(' */\n\n')
+        guard = os.path.basename(args.output).upper().replace('.', '_')
+        f.write(f'#ifndef {guard}\n#define {guard}\n\n#include <stdint.h>\n\n')
+        f.write(f'#define DDC_CIC_R {CIC_R}\n')
+        f.write(f'#define DDC_CIC_SHIFT {CIC_SHIFT}\n')
+        f.write(f'#define DDC_FIR_TAPS {args.taps}\n')
+        f.write(f'#define DDC_NCO_BITS {NCO_BITS}\n')
+        f.write(f'#define DDC_NCO_LEN {nco_len}\n\n')
+        f.write('static const int16_t ddc_fir_q15[DDC_FIR_TAPS] = {\n')
+        for i in range(0, len(taps_q15), 8):
+            f.write(','.join(str(v) for v in taps_q15[i:i + 8]))
+            f.write(',\n' if i + 8 < len(taps_q15) else '\n')
+        f.write('};\n\n')
+        f.write('static const int16_t ddc_nco_q15[DDC_NCO_LEN + DDC_NCO_LEN / 4] = {\n')
+        for i in range(0, len(nco), 12):
+            f.write(','.join(str(v) for v in nco[i:i + 12]))
+            f.write(',\n' if i + 12 < len(nco) else '\n')
+        f.write(f'}};\n\n#endif // {guard}\n')
+    print(f'Wrote {args.output}')
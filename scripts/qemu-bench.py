@@ -0,0 +1,78 @@
+'''
+Run the QEMU_Bench firmware under qemu-system-arm and check it against a
+baseline log.
+
+Exits non-zero if any kernel retires more instructions per sample than the
+baseline by more than the given tolerance, so it can gate changes on any
+Linux box without target hardware.
+'''
+import argparse
+import json
+import subprocess
+import sys
+
+QEMU_ARGS = ['-M', 'mps2-an500', '-nographic', '-monitor', 'none', '-serial', 'none',
+             '-icount', 'shift=0', '-semihosting-config', 'enable=on,target=native']
+
+
+def run(qemu, elf, timeout):
+    '''
+    Run the benchmark, return the raw JSON lines.
+    '''
+    proc = subprocess.run([qemu] + QEMU_ARGS + ['-kernel', elf],
+                          capture_output=True, text=True, timeout=timeout)
+    if proc.returncode != 0:
+        print(proc.stdout)
+        print(proc.stderr)
+        print(f'QEMU exited with {proc.returncode}')
+        sys.exit(1)
+    return [line for line in proc.stdout.splitlines() if line.startswith('{')]
+
+
+def per_kernel(lines):
+    results = {}
+    for line in lines:
+        rec = json.loads(line)
+        if 'kernel' in rec:
+            results[rec['kernel']] = rec['insn_per_sample']
+    return results
+
+
+if __name__ == '__main__':
+
+    parser = argparse.ArgumentParser("qemu-bench")
+    parser.add_argument("elf", type=str)
+    parser.add_argument("--qemu", type=str, default='qemu-system-arm')
+    parser.add_argument("--output", type=str, default=None)
+    parser.add_argument("--baseline", type=str, default=None)
+    parser.add_argument("--tolerance", type=float, default=2.0, help="allowed increase in percent")
+    parser.add_argument("--timeout", type=float, default=600)
+    args = parser.parse_args()
+
+    lines = run(args.qemu, args.elf, args.timeout)
+    for line in lines:
+        print(line)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write('\n'.join(lines) + '\n')
+
+    if not args.baseline:
+        sys.exit(0)
+
+    with open(args.baseline) as f:
+        base = per_kernel([line for line in f if line.startswith('{')])
+    cand = per_kernel(lines)
+
+    failed = False
+    for kernel, insn in sorted(cand.items()):
+        if kernel not in base:
+            continue
+        change = 100.0 * (insn - base[kernel]) / base[kernel]
+        status = 'ok'
+        if change > args.tolerance:
+            status = 'REGRESSION'
+            failed = True
+        print(f'{kernel:<28}{base[kernel]:>12.3f}{insn:>12.3f}{change:>+9.1f}%  {status}')
+
+    sys.exit(1 if failed else 0)